@@ -2,11 +2,14 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <optional>
 #include <stdexcept>
 #include <iostream>
 #include "../perser/ast.h"
 #include "../symbol/symbol_table.h"
+#include "../symbol/global_symbol_table.h"
 #include "../runtime/value.h"
+#include "../runtime/float_ops.h"
 
 using namespace std;
 
@@ -19,8 +22,14 @@ public:
         visitProgram(program.get());
     }
 
+    // Global symbols frozen at the end of analysis, shared with the engine
+    std::shared_ptr<GlobalSymbolTable> getGlobals() const {
+        return globals;
+    }
+
 private:
     std::shared_ptr<SymbolTable> symbolTable;
+    std::shared_ptr<GlobalSymbolTable> globals;
 
     void visitProgram(ProgramBlock* program) {
         symbolTable->enterScope();  // Global scope
@@ -39,6 +48,12 @@ private:
             }
         }
         
+        // Freeze operations, functions, blocks and builtins for the engine
+        globals = std::make_shared<GlobalSymbolTable>(*symbolTable);
+        // Builtin names are resolved and nothing executes yet, so registry
+        // tables superseded by plugin registration can be freed
+        BuiltinsRegistry::getInstance().reclaim();
+        
         symbolTable->exitScope();  // Exit global scope
     }
 
@@ -130,16 +145,15 @@ private:
     void visitLetStatement(LetStmt* stmt) {
         // Convert the value string to a Value object
         Value value;
-        // Try to parse as number first, otherwise treat as string
-        try {
-            double numVal = std::stod(stmt->value);
-            value = Value(numVal);
-        } catch (...) {
+        // Numbers become FLOAT, everything else stays a STRING
+        if (std::optional<double> number = parseFloat(stmt->value)) {
+            value = Value(*number);
+        } else {
             value = Value(stmt->value);
         }
         
         // Define the variable in the current scope
-        symbolTable->defineVariable(stmt->name, value);
+        symbolTable->defineVariable(stmt->name, std::move(value));
     }
 
     void visitSayStatement(SayStmt* stmt) {
@@ -1,11 +1,22 @@
 #pragma once
+#include <cassert>
+#include <cstdint>
 #include <string>
-#include <functional>
-#include <unordered_map>
+#include <deque>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <iostream>
 #include "../runtime/value.h"
+#include "../runtime/simd_ops.h"
+#include "../runtime/regex.h"
+#include "../runtime/string_ops.h"
+#include "../runtime/sort.h"
+#include "../runtime/table.h"
+#include "../runtime/snapshot_ptr.h"
+#include "../runtime/intrinsic_ops.h"
+#include "plugin_api.h"
+#include "../symbol/string_interner.h"
 
 using namespace std;
 
@@ -20,21 +31,80 @@ enum class BuiltinKind {
     REGEX_OP,
     FILE_OP,
     NETWORK_OP,
-    SIMD_OP
+    SIMD_OP,
+    ARRAY_OP,
+    TABLE_OP
 };
 
-// Function signature for builtin functions
-using BuiltinFunction = std::function<Value(const std::vector<Value>&)>;
+// ================= CALLING CONVENTION =================
+// Arguments are a view of consecutive Values (normally the top of the
+// engine's value stack) and the result is written to a caller-provided slot,
+// so a call never builds an argument vector. The result slot never aliases
+// the arguments.
+struct ValueSpan {
+    const Value* data = nullptr;
+    size_t count = 0;
+
+    ValueSpan() = default;
+    ValueSpan(const Value* d, size_t n) : data(d), count(n) {}
+    ValueSpan(const std::vector<Value>& values) : data(values.data()), count(values.size()) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Value& operator[](size_t i) const { return data[i]; }
+    const Value* begin() const { return data; }
+    const Value* end() const { return data + count; }
+};
+
+// Function signatures for builtin functions (plain function pointers; the
+// builtins are captureless lambdas). Every builtin has the span entry;
+// the fixed-arity entries are optional fast paths for 1-3 arguments.
+using BuiltinFunction = void (*)(ValueSpan args, Value& result);
+using BuiltinFunction1 = void (*)(const Value& a, Value& result);
+using BuiltinFunction2 = void (*)(const Value& a, const Value& b, Value& result);
+using BuiltinFunction3 = void (*)(const Value& a, const Value& b, const Value& c, Value& result);
+
+// Dense index into the registry's dispatch table, assigned at registration
+using BuiltinId = uint16_t;
+
+constexpr BuiltinId kInvalidBuiltinId = UINT16_MAX;
+
+// ================= INTRINSICS =================
+// What the compiler may assume about a builtin (see compiler/ir/ir_builder.h)
+enum IntrinsicFlags : uint8_t {
+    INTRINSIC_PURE = 1 << 0,    // no side effects; an unused call may be dropped
+    INTRINSIC_CONST = 1 << 1    // result depends only on the arguments; may be folded
+};
+
+struct Intrinsic {
+    uint8_t flags = 0;
+    // Direct lowering: when all argCount operands are known to have
+    // operandType, the call becomes op instead of CALL_BUILTIN
+    IrOp op = IrOp::CALL_BUILTIN;
+    IrType operandType = IrType::UNKNOWN;
+    IrType resultType = IrType::UNKNOWN;   // type of the lowered op's result
+    // LLVM IR for the lowered op with $0.. as operands, e.g. "fmul double $0, $1"
+    const char* llvm = nullptr;
+};
 
 // ================= BUILTIN DEFINITION =================
 struct Builtin {
-    std::string name;
+    SymbolId nameId;   // interned name
+    BuiltinId id;
     BuiltinKind kind;
     int argCount;  // -1 for variable arguments
-    BuiltinFunction implementation;
+    Intrinsic intrinsic;
+    BuiltinFunction implementation;   // null for native plugin builtins
+    
+    Builtin(SymbolId n, BuiltinId i, BuiltinKind k, int args, Intrinsic in, BuiltinFunction impl)
+        : nameId(n), id(i), kind(k), argCount(args), intrinsic(in), implementation(impl) {}
     
-    Builtin(const std::string& n, BuiltinKind k, int args, BuiltinFunction impl)
-        : name(n), kind(k), argCount(args), implementation(impl) {}
+    const std::string& name() const {
+        return StringInterner::getInstance().text(nameId);
+    }
+    
+    bool isPure() const { return (intrinsic.flags & INTRINSIC_PURE) != 0; }
+    bool isConst() const { return (intrinsic.flags & INTRINSIC_CONST) != 0; }
 };
 
 // ================= BUILTINS REGISTRY =================
@@ -45,113 +115,1115 @@ public:
         return instance;
     }
     
-    // Register a builtin function
-    void registerBuiltin(const std::string& name, BuiltinKind kind, 
-                        int argCount, BuiltinFunction implementation) {
-        builtins_[name] = std::make_unique<Builtin>(name, kind, argCount, implementation);
+    // Register a builtin function (re-registering a name replaces it in place,
+    // keeping its BuiltinId). A pure builtin is also const: it has no side
+    // effects and its result depends only on its arguments.
+    BuiltinId registerBuiltin(const std::string& name, BuiltinKind kind, 
+                              int argCount, BuiltinFunction implementation, bool pure = false) {
+        SymbolId nameId = internString(name);
+        BuiltinId id = kInvalidBuiltinId;
+        edit([&](Table& t) {
+            id = insert(t, nameId, kind, argCount, implementation, pure);
+        });
+        return id;
     }
     
-    // Get a builtin function
-    Builtin* getBuiltin(const std::string& name) {
-        auto it = builtins_.find(name);
-        if (it != builtins_.end()) {
-            return it->second.get();
+    // Builtin implemented by a native plugin (see plugin_loader.h); api is
+    // the host table handed to it on every call
+    BuiltinId registerNative(const std::string& name, BuiltinKind kind, int argCount,
+                             bool pure, NexBuiltinFn fn, const NexHostApi* api) {
+        SymbolId nameId = internString(name);
+        BuiltinId id = kInvalidBuiltinId;
+        edit([&](Table& t) {
+            id = insert(t, nameId, kind, argCount, nullptr, pure);
+            t.natives[id] = fn;
+            t.nativeApi = api;
+        });
+        return id;
+    }
+    
+    // Error raised by the native builtin running on this thread
+    static std::string& nativeError() {
+        thread_local std::string error;
+        return error;
+    }
+    
+    // Name -> BuiltinId; done once by the semantic analyzer, not per call
+    BuiltinId resolve(SymbolId nameId) const {
+        const Table& t = table();
+        return nameId < t.ids.size() ? t.ids[nameId] : kInvalidBuiltinId;
+    }
+    
+    BuiltinId resolve(const std::string& name) const {
+        return resolve(StringInterner::getInstance().find(name));
+    }
+    
+    // Fixed-arity fast entries; must do what the span entry does for that
+    // many arguments
+    void addFastEntry(BuiltinId id, BuiltinFunction1 fn) {
+        edit([&](Table& t) { t.fixed1[id] = fn; });
+    }
+    void addFastEntry(BuiltinId id, BuiltinFunction2 fn) {
+        edit([&](Table& t) { t.fixed2[id] = fn; });
+    }
+    void addFastEntry(BuiltinId id, BuiltinFunction3 fn) {
+        edit([&](Table& t) { t.fixed3[id] = fn; });
+    }
+    
+    // Lowering for the compiler; must agree with the builtin's behaviour on
+    // operands of intrinsic.operandType
+    void setIntrinsic(BuiltinId id, const Intrinsic& intrinsic) {
+        edit([&](Table& t) { t.builtins[id].intrinsic = intrinsic; });
+    }
+    
+    const Builtin& builtin(BuiltinId id) const {
+        return table().builtins[id];
+    }
+    
+    // Dispatch a resolved builtin: one indexed indirect call. The id must
+    // come from resolve() or registration; it is only checked in debug builds.
+    void call(BuiltinId id, ValueSpan args, Value& result) const {
+        const Table& t = table();
+        assert(id < t.functions.size() && "unresolved BuiltinId");
+        switch (args.size()) {
+            case 1:
+                if (t.fixed1[id]) return t.fixed1[id](args[0], result);
+                break;
+            case 2:
+                if (t.fixed2[id]) return t.fixed2[id](args[0], args[1], result);
+                break;
+            case 3:
+                if (t.fixed3[id]) return t.fixed3[id](args[0], args[1], args[2], result);
+                break;
         }
-        return nullptr;
+        if (t.functions[id]) {
+            t.functions[id](args, result);
+        } else {
+            callNative(t, id, args, result);
+        }
+    }
+    
+    // Call with arguments that are not already contiguous. Without a fast
+    // entry the arguments are copied side by side: span entries and native
+    // plugins read them as one array of Values, and a and b may live
+    // anywhere. Copying a Value shares its heap payload, so this costs
+    // refcount bumps, not allocations.
+    void call(BuiltinId id, const Value& a, Value& result) const {
+        const Table& t = table();
+        assert(id < t.functions.size() && "unresolved BuiltinId");
+        if (t.fixed1[id]) return t.fixed1[id](a, result);
+        call(id, ValueSpan(&a, 1), result);
+    }
+    
+    void call(BuiltinId id, const Value& a, const Value& b, Value& result) const {
+        const Table& t = table();
+        assert(id < t.functions.size() && "unresolved BuiltinId");
+        if (t.fixed2[id]) return t.fixed2[id](a, b, result);
+        const Value args[2] = {a, b};
+        call(id, ValueSpan(args, 2), result);
+    }
+    
+    void call(BuiltinId id, const Value& a, const Value& b, const Value& c, Value& result) const {
+        const Table& t = table();
+        assert(id < t.functions.size() && "unresolved BuiltinId");
+        if (t.fixed3[id]) return t.fixed3[id](a, b, c, result);
+        const Value args[3] = {a, b, c};
+        call(id, ValueSpan(args, 3), result);
+    }
+    
+    // Call on the top argc entries of a value stack; they are replaced by
+    // the result. Reuses the stack's storage, so nothing is allocated.
+    void callOnStack(BuiltinId id, std::vector<Value>& stack, size_t argc) const {
+        size_t base = stack.size() - argc;
+        Value result;
+        call(id, ValueSpan(stack.data() + base, argc), result);
+        stack.resize(base);
+        stack.push_back(std::move(result));
+    }
+    
+    // Flat dispatch table indexed by BuiltinId, as of this call (null
+    // entries are native plugin builtins; dispatch those through call())
+    const BuiltinFunction* functionTable() const {
+        return table().functions.data();
+    }
+    
+    size_t size() const {
+        return table().builtins.size();
+    }
+    
+    // Get a builtin function (the entry as of this call; a later
+    // registration publishes a new one)
+    const Builtin* getBuiltinById(BuiltinId id) const {
+        const Table& t = table();
+        return id < t.builtins.size() ? &t.builtins[id] : nullptr;
+    }
+    
+    const Builtin* getBuiltin(SymbolId nameId) const {
+        return getBuiltinById(resolve(nameId));
+    }
+    
+    const Builtin* getBuiltin(const std::string& name) const {
+        return getBuiltinById(resolve(name));
     }
     
     // Check if a name is a builtin
-    bool isBuiltin(const std::string& name) {
-        return builtins_.find(name) != builtins_.end();
+    bool isBuiltin(SymbolId nameId) const {
+        return resolve(nameId) != kInvalidBuiltinId;
+    }
+    
+    bool isBuiltin(const std::string& name) const {
+        return isBuiltin(StringInterner::getInstance().find(name));
     }
     
-    // Initialize all builtins
+    // Free superseded tables. Only call while no other thread can be
+    // inside the registry (e.g. after the executors have been joined).
+    // Only registrations after startup (plugins) supersede a table.
+    void reclaim() {
+        table_.reclaim();
+    }
+    
+private:
+    // Register all builtins; called once by the constructor, while
+    // registration fills the initial table in place
     void initializeBuiltins() {
         // SAY builtin
-        registerBuiltin("Say", BuiltinKind::SAY, 1, [](const std::vector<Value>& args) -> Value {
+        BuiltinId say = registerBuiltin("Say", BuiltinKind::SAY, 1, [](ValueSpan args, Value& result) {
             if (!args.empty()) {
                 std::cout << args[0].toString() << std::endl;
             }
-            return Value();  // Return empty value
+            result = Value();  // Return empty value
+        });
+        addFastEntry(say, [](const Value& message, Value& result) {
+            std::cout << message.toString() << std::endl;
+            result = Value();
         });
         
         // OPEN_FILE builtin
-        registerBuiltin("open", BuiltinKind::OPEN_FILE, 1, [](const std::vector<Value>& args) -> Value {
+        BuiltinId open = registerBuiltin("open", BuiltinKind::OPEN_FILE, 1, [](ValueSpan args, Value& result) {
+            result = Value();
             if (!args.empty()) {
-                // In a real implementation, this would open a file handle
-                // For now, we'll simulate it
-                std::string filename = args[0].toString();
-                Handle fileHandle("file", nullptr, 1);  // Simulated file handle
-                return Value(fileHandle);
+                BuiltinsRegistry::openFile(args[0], result);
             }
-            return Value();
         });
+        addFastEntry(open, &BuiltinsRegistry::openFile);
         
         // READ_FILE builtin
-        registerBuiltin("Read", BuiltinKind::READ_FILE, 1, [](const std::vector<Value>& args) -> Value {
-            if (!args.empty()) {
-                // In a real implementation, this would read from a file handle
-                // For now, we'll return a dummy string
-                return Value("<file_contents>");
-            }
-            return Value();
+        BuiltinId read = registerBuiltin("Read", BuiltinKind::READ_FILE, 1, [](ValueSpan args, Value& result) {
+            // In a real implementation, this would read from a file handle
+            // For now, we'll return a dummy string
+            result = args.empty() ? Value() : Value("<file_contents>");
+        });
+        addFastEntry(read, [](const Value&, Value& result) {
+            result = Value("<file_contents>");
         });
         
         // WRITE_FILE builtin
-        registerBuiltin("Write", BuiltinKind::WRITE_FILE, -1, [](const std::vector<Value>& args) -> Value {
-            if (args.size() >= 3) {
-                // In a real implementation, this would write to a file
-                // args[0]: content, args[1]: filename, args[2]: location
-                // For now, we'll just return success
-                return Value(true);
-            }
-            return Value(false);
+        // In a real implementation, this would write to a file
+        // args[0]: content, args[1]: filename, args[2]: location
+        // For now, we'll just return success
+        BuiltinId write = registerBuiltin("Write", BuiltinKind::WRITE_FILE, -1, [](ValueSpan args, Value& result) {
+            result = Value(args.size() >= 3);
+        });
+        addFastEntry(write, [](const Value&, const Value&, const Value&, Value& result) {
+            result = Value(true);
         });
         
         // Math operations
-        registerBuiltin("Add", BuiltinKind::MATH_OP, 2, [](const std::vector<Value>& args) -> Value {
+        BuiltinId add = registerBuiltin("Add", BuiltinKind::MATH_OP, 2, [](ValueSpan args, Value& result) {
+            result = args.size() >= 2 ? args[0] + args[1] : Value(0.0);
+        }, true);
+        addFastEntry(add, [](const Value& a, const Value& b, Value& result) {
+            result = a + b;
+        });
+        setIntrinsic(add, lowering(IrOp::FADD, IrType::FLOAT, IrType::FLOAT, "fadd double $0, $1"));
+        
+        BuiltinId subtract = registerBuiltin("Subtract", BuiltinKind::MATH_OP, 2, [](ValueSpan args, Value& result) {
+            result = args.size() >= 2 ? args[0] - args[1] : Value(0.0);
+        }, true);
+        addFastEntry(subtract, [](const Value& a, const Value& b, Value& result) {
+            result = a - b;
+        });
+        setIntrinsic(subtract, lowering(IrOp::FSUB, IrType::FLOAT, IrType::FLOAT, "fsub double $0, $1"));
+        
+        BuiltinId multiply = registerBuiltin("Multiply", BuiltinKind::MATH_OP, 2, [](ValueSpan args, Value& result) {
+            result = args.size() >= 2 ? args[0] * args[1] : Value(0.0);
+        }, true);
+        addFastEntry(multiply, [](const Value& a, const Value& b, Value& result) {
+            result = a * b;
+        });
+        setIntrinsic(multiply, lowering(IrOp::FMUL, IrType::FLOAT, IrType::FLOAT, "fmul double $0, $1"));
+        
+        BuiltinId divide = registerBuiltin("Divide", BuiltinKind::MATH_OP, 2, [](ValueSpan args, Value& result) {
+            result = args.size() >= 2 ? args[0] / args[1] : Value(0.0);
+        }, true);
+        addFastEntry(divide, [](const Value& a, const Value& b, Value& result) {
+            result = a / b;
+        });
+        // No direct lowering: division by zero must still raise the builtin's error
+        
+        // String operations
+        BuiltinId concat = registerBuiltin("Concat", BuiltinKind::STRING_OP, 2, [](ValueSpan args, Value& result) {
+            // Uses Value's + operator for concatenation
+            result = args.size() >= 2 ? args[0] + args[1] : Value("");
+        }, true);
+        addFastEntry(concat, [](const Value& a, const Value& b, Value& result) {
+            result = a + b;
+        });
+        setIntrinsic(concat, lowering(IrOp::CONCAT, IrType::STRING, IrType::STRING));
+        
+        // Position of needle in text, or -1
+        registerPureOp<&BuiltinsRegistry::stringFind>(BuiltinKind::STRING_OP, "String_Find");
+        registerPureOp<&BuiltinsRegistry::stringContains>(BuiltinKind::STRING_OP, "String_Contains");
+        registerPureOp<&BuiltinsRegistry::stringCount>(BuiltinKind::STRING_OP, "String_Count");
+        // args[0]: text, args[1]: needle, args[2]: replacement for every needle
+        registerPureOp<&BuiltinsRegistry::stringReplace>(BuiltinKind::STRING_OP, "String_Replace");
+        registerPureOp<&BuiltinsRegistry::stringSplit>(BuiltinKind::STRING_OP, "String_Split");
+        registerPureOp<&BuiltinsRegistry::stringTrim>(BuiltinKind::STRING_OP, "String_Trim");
+        registerPureOp<&BuiltinsRegistry::stringUpper>(BuiltinKind::STRING_OP, "String_Upper");
+        registerPureOp<&BuiltinsRegistry::stringLower>(BuiltinKind::STRING_OP, "String_Lower");
+        registerPureOp<&BuiltinsRegistry::stringValidUtf8>(BuiltinKind::STRING_OP, "String_ValidUtf8");
+        // Length in code points (UTF-8)
+        registerPureOp<&BuiltinsRegistry::stringLength>(BuiltinKind::STRING_OP, "String_Length");
+        
+        // Regex operations; patterns are compiled once per thread and cached
+        BuiltinId regexMatch = registerBuiltin("Regex_Match", BuiltinKind::REGEX_OP, 2, [](ValueSpan args, Value& result) {
+            result = Value(false);
             if (args.size() >= 2) {
-                return args[0] + args[1];
+                BuiltinsRegistry::regexMatch(args[0], args[1], result);
             }
-            return Value(0.0);
-        });
+        }, true);
+        addFastEntry(regexMatch, &BuiltinsRegistry::regexMatch);
         
-        registerBuiltin("Subtract", BuiltinKind::MATH_OP, 2, [](const std::vector<Value>& args) -> Value {
+        // Position of the first match, or -1
+        BuiltinId regexSearch = registerBuiltin("Regex_Search", BuiltinKind::REGEX_OP, 2, [](ValueSpan args, Value& result) {
+            result = Value(-1.0);
             if (args.size() >= 2) {
-                return args[0] - args[1];
+                BuiltinsRegistry::regexSearch(args[0], args[1], result);
             }
-            return Value(0.0);
-        });
+        }, true);
+        addFastEntry(regexSearch, &BuiltinsRegistry::regexSearch);
+        
+        // args[0]: text, args[1]: pattern, args[2]: replacement for every match
+        BuiltinId regexReplace = registerBuiltin("Regex_Replace", BuiltinKind::REGEX_OP, 3, [](ValueSpan args, Value& result) {
+            result = args.empty() ? Value("") : args[0];
+            if (args.size() >= 3) {
+                BuiltinsRegistry::regexReplace(args[0], args[1], args[2], result);
+            }
+        }, true);
+        addFastEntry(regexReplace, &BuiltinsRegistry::regexReplace);
         
-        registerBuiltin("Multiply", BuiltinKind::MATH_OP, 2, [](const std::vector<Value>& args) -> Value {
+        BuiltinId regexSplit = registerBuiltin("Regex_Split", BuiltinKind::REGEX_OP, 2, [](ValueSpan args, Value& result) {
+            result = Value();
             if (args.size() >= 2) {
-                return args[0] * args[1];
+                BuiltinsRegistry::regexSplit(args[0], args[1], result);
             }
-            return Value(0.0);
-        });
+        }, true);
+        addFastEntry(regexSplit, &BuiltinsRegistry::regexSplit);
         
-        registerBuiltin("Divide", BuiltinKind::MATH_OP, 2, [](const std::vector<Value>& args) -> Value {
+        // Array operations
+        registerBuiltin("Create_Array", BuiltinKind::ARRAY_OP, -1, [](ValueSpan args, Value& result) {
+            // FLOAT arguments are stored unboxed; any other argument makes it a
+            // string array (text is kept as written, so "1.50" stays "1.50")
+            ArrayRep* array = new ArrayRep();
+            array->reserve(args.size());
+            for (const Value& arg : args) {
+                if (arg.getType() == ValueType::FLOAT) {
+                    array->appendFloat(arg.getFloat());
+                } else {
+                    array->appendString(arg.toString());
+                }
+            }
+            result = Value(array);
+        }, true);
+        
+        BuiltinId arrayLength = registerBuiltin("ArrayLength", BuiltinKind::ARRAY_OP, 1, [](ValueSpan args, Value& result) {
+            result = Value(0.0);
+            if (!args.empty()) {
+                BuiltinsRegistry::arrayLength(args[0], result);
+            }
+        }, true);
+        addFastEntry(arrayLength, &BuiltinsRegistry::arrayLength);
+        
+        BuiltinId arrayGet = registerBuiltin("ArrayGet", BuiltinKind::ARRAY_OP, 2, [](ValueSpan args, Value& result) {
+            result = Value();
             if (args.size() >= 2) {
-                return args[0] / args[1];
+                BuiltinsRegistry::arrayGet(args[0], args[1], result);
             }
-            return Value(0.0);
-        });
+        }, true);
+        addFastEntry(arrayGet, &BuiltinsRegistry::arrayGet);
         
-        // String operations
-        registerBuiltin("Concat", BuiltinKind::STRING_OP, 2, [](const std::vector<Value>& args) -> Value {
+        // Batch operations over FLOAT arrays, run by the SIMD kernels
+        registerBinaryBatch("Batch_Add", IrOp::VADD, &BuiltinsRegistry::batchBinary<&SimdKernels::add>,
+                            &BuiltinsRegistry::batchBinarySpan<&SimdKernels::add>);
+        registerBinaryBatch("Batch_Multiply", IrOp::VMUL, &BuiltinsRegistry::batchBinary<&SimdKernels::mul>,
+                            &BuiltinsRegistry::batchBinarySpan<&SimdKernels::mul>);
+        registerBinaryBatch("Batch_Less", IrOp::VCMP_LT, &BuiltinsRegistry::batchCompare<CompareOp::LESS>,
+                            &BuiltinsRegistry::batchCompareSpan<CompareOp::LESS>);
+        registerBinaryBatch("Batch_Equal", IrOp::VCMP_EQ, &BuiltinsRegistry::batchCompare<CompareOp::EQUAL>,
+                            &BuiltinsRegistry::batchCompareSpan<CompareOp::EQUAL>);
+        registerBinaryBatch("Batch_Greater", IrOp::VCMP_GT, &BuiltinsRegistry::batchCompare<CompareOp::GREATER>,
+                            &BuiltinsRegistry::batchCompareSpan<CompareOp::GREATER>);
+        registerBinaryBatch("Batch_Dot", IrOp::VDOT, &BuiltinsRegistry::batchDot, [](ValueSpan args, Value& result) {
+            result = Value();
             if (args.size() >= 2) {
-                return args[0] + args[1];  // Uses Value's + operator for concatenation
+                BuiltinsRegistry::batchDot(args[0], args[1], result);
             }
-            return Value("");
-        });
+        }, IrType::FLOAT);
+        
+        // a * b + c
+        BuiltinId batchFma = registerBuiltin("Batch_FMA", BuiltinKind::SIMD_OP, 3, [](ValueSpan args, Value& result) {
+            result = Value();
+            if (args.size() >= 3) {
+                BuiltinsRegistry::batchFma(args[0], args[1], args[2], result);
+            }
+        }, true);
+        addFastEntry(batchFma, &BuiltinsRegistry::batchFma);
+        setIntrinsic(batchFma, lowering(IrOp::VFMA, IrType::FLOAT_ARRAY, IrType::FLOAT_ARRAY));
+        
+        BuiltinId batchSum = registerBuiltin("Batch_Sum", BuiltinKind::SIMD_OP, 1,
+                                             &BuiltinsRegistry::batchReduceSpan<&SimdKernels::sum>, true);
+        addFastEntry(batchSum, &BuiltinsRegistry::batchReduce<&SimdKernels::sum>);
+        setIntrinsic(batchSum, lowering(IrOp::VSUM, IrType::FLOAT_ARRAY, IrType::FLOAT));
+        BuiltinId batchMin = registerBuiltin("Batch_Min", BuiltinKind::SIMD_OP, 1,
+                                             &BuiltinsRegistry::batchReduceSpan<&SimdKernels::min>, true);
+        addFastEntry(batchMin, &BuiltinsRegistry::batchReduce<&SimdKernels::min>);
+        setIntrinsic(batchMin, lowering(IrOp::VMIN, IrType::FLOAT_ARRAY, IrType::FLOAT));
+        BuiltinId batchMax = registerBuiltin("Batch_Max", BuiltinKind::SIMD_OP, 1,
+                                             &BuiltinsRegistry::batchReduceSpan<&SimdKernels::max>, true);
+        addFastEntry(batchMax, &BuiltinsRegistry::batchReduce<&SimdKernels::max>);
+        setIntrinsic(batchMax, lowering(IrOp::VMAX, IrType::FLOAT_ARRAY, IrType::FLOAT));
+        
+        // Sorts; large arrays are sorted on the thread pool
+        registerPureOp<&BuiltinsRegistry::sortArray>(BuiltinKind::ARRAY_OP, "Sort");
+        // Reorder by a parallel keys array; Sort_By keeps equal keys in order
+        registerPureOp<&BuiltinsRegistry::sortBy<true>>(BuiltinKind::ARRAY_OP, "Sort_By");
+        registerPureOp<&BuiltinsRegistry::sortBy<false>>(BuiltinKind::ARRAY_OP, "Sort_By_Unstable");
+        // The k largest elements, largest first
+        registerPureOp<&BuiltinsRegistry::sortTopK>(BuiltinKind::ARRAY_OP, "Sort_TopK");
+        
+        // Columnar tables
+        // Create_Table(name, array, name, array, ...)
+        registerBuiltin("Create_Table", BuiltinKind::TABLE_OP, -1, &BuiltinsRegistry::createTable, true);
+        registerPureOp<&BuiltinsRegistry::tableFromCsvText>(BuiltinKind::TABLE_OP, "Table_FromCsv");
+        registerPureOp<&BuiltinsRegistry::tableRows>(BuiltinKind::TABLE_OP, "Table_Rows");
+        registerPureOp<&BuiltinsRegistry::tableColumns>(BuiltinKind::TABLE_OP, "Table_Columns");
+        registerPureOp<&BuiltinsRegistry::tableColumn>(BuiltinKind::TABLE_OP, "Table_Column");
+        // Table_Get(table, row, column)
+        registerPureOp<&BuiltinsRegistry::tableGet>(BuiltinKind::TABLE_OP, "Table_Get");
+        // Table_Select(table, column, column, ...)
+        registerBuiltin("Table_Select", BuiltinKind::TABLE_OP, -1, &BuiltinsRegistry::tableSelect, true);
+        // Table_Filter(table, column, "<", value)
+        registerBuiltin("Table_Filter", BuiltinKind::TABLE_OP, 4, &BuiltinsRegistry::tableFilter, true);
+        // Table_Aggregate(table, column, "sum")
+        registerPureOp<&BuiltinsRegistry::tableAggregate>(BuiltinKind::TABLE_OP, "Table_Aggregate");
+        // Table_GroupBy(table, key, column, "sum")
+        registerBuiltin("Table_GroupBy", BuiltinKind::TABLE_OP, 4, &BuiltinsRegistry::tableGroupBy, true);
+    }
+    
+    // ================= TABLE SNAPSHOTS =================
+    // All lookup state lives in one immutable Table. Lookups and calls read
+    // the current version with a single acquire load and no lock, so
+    // executor threads never wait. Registration copies the table, edits the
+    // copy and publishes it (see SnapshotPtr); superseded versions stay
+    // alive until reclaim(), so a call already running on one is safe.
+    struct Table {
+        std::deque<Builtin> builtins;          // indexed by BuiltinId
+        std::vector<BuiltinFunction> functions;  // dispatch table, indexed by BuiltinId
+        std::vector<BuiltinFunction1> fixed1;  // fast entries, indexed by BuiltinId (may be null)
+        std::vector<BuiltinFunction2> fixed2;
+        std::vector<BuiltinFunction3> fixed3;
+        std::vector<NexBuiltinFn> natives;     // plugin entries, indexed by BuiltinId (may be null)
+        const NexHostApi* nativeApi = nullptr;
+        std::vector<BuiltinId> ids;            // indexed by SymbolId
+    };
+    
+    SnapshotPtr<Table> table_;
+    // Table being filled by the constructor; published once it is complete
+    Table* initial_ = nullptr;
+    
+    const Table& table() const {
+        return *table_.load();
+    }
+    
+    // Registration edits the initial table in place while the constructor
+    // runs, so startup publishes one table instead of one per builtin
+    template <typename Fn>
+    void edit(Fn&& fn) {
+        if (initial_) {
+            fn(*initial_);
+        } else {
+            table_.update(std::forward<Fn>(fn));
+        }
+    }
+    
+    static BuiltinId insert(Table& t, SymbolId nameId, BuiltinKind kind, int argCount,
+                            BuiltinFunction implementation, bool pure) {
+        Intrinsic intrinsic;
+        intrinsic.flags = pure ? (INTRINSIC_PURE | INTRINSIC_CONST) : 0;
+        BuiltinId id = nameId < t.ids.size() ? t.ids[nameId] : kInvalidBuiltinId;
+        if (id != kInvalidBuiltinId) {
+            t.builtins[id] = Builtin(nameId, id, kind, argCount, intrinsic, implementation);
+            t.functions[id] = implementation;
+            t.fixed1[id] = nullptr;
+            t.fixed2[id] = nullptr;
+            t.fixed3[id] = nullptr;
+            t.natives[id] = nullptr;
+            return id;
+        }
+        
+        if (t.builtins.size() >= kInvalidBuiltinId) {
+            throw std::runtime_error("Too many builtins");
+        }
+        id = static_cast<BuiltinId>(t.builtins.size());
+        t.builtins.emplace_back(nameId, id, kind, argCount, intrinsic, implementation);
+        t.functions.push_back(implementation);
+        t.fixed1.push_back(nullptr);
+        t.fixed2.push_back(nullptr);
+        t.fixed3.push_back(nullptr);
+        t.natives.push_back(nullptr);
+        if (nameId >= t.ids.size()) {
+            t.ids.resize(nameId + 1, kInvalidBuiltinId);
+        }
+        t.ids[nameId] = id;
+        return id;
+    }
+    
+    // Values cross the plugin ABI as opaque pointers to the Values themselves
+    static void callNative(const Table& t, BuiltinId id, ValueSpan args, Value& result) {
+        std::string& error = nativeError();
+        t.natives[id](reinterpret_cast<const NexValue*>(args.data), args.size(),
+                      reinterpret_cast<NexValue*>(&result), t.nativeApi);
+        if (!error.empty()) {
+            std::string message = t.builtins[id].name() + ": " + error;
+            error.clear();
+            throw std::runtime_error(message);
+        }
+    }
+    
+    // Intrinsic of a pure builtin that lowers to op
+    static Intrinsic lowering(IrOp op, IrType operandType, IrType resultType, const char* llvm = nullptr) {
+        Intrinsic intrinsic;
+        intrinsic.flags = INTRINSIC_PURE | INTRINSIC_CONST;
+        intrinsic.op = op;
+        intrinsic.operandType = operandType;
+        intrinsic.resultType = resultType;
+        intrinsic.llvm = llvm;
+        return intrinsic;
+    }
+    
+    // Shared bodies of builtins whose span and fixed entries do the same work
+    static void openFile(const Value& filename, Value& result) {
+        // In a real implementation, this would open a file handle
+        // Simulated file: a live slot with no resource behind it
+        (void)filename;
+        result = Value(HandleTable::getInstance().open(HandleKind::FILE, nullptr));
+    }
+    
+    static void arrayLength(const Value& array, Value& result) {
+        result = Value(array.getType() == ValueType::ARRAY ? static_cast<double>(array.getArray().size()) : 0.0);
+    }
+    
+    static void arrayGet(const Value& array, const Value& index, Value& result) {
+        if (array.getType() != ValueType::ARRAY) {
+            result = Value();
+            return;
+        }
+        // Checked as a double: casting a negative, NaN or huge index is undefined
+        double at = index.toFloat();
+        if (!(at >= 0) || at >= static_cast<double>(array.getArray().size())) {
+            throw std::runtime_error("Array index out of range");
+        }
+        result = array.arrayElement(static_cast<size_t>(at));
+    }
+    
+    // ================= STRING BUILTINS =================
+    // Arguments that are not strings are used in their string form. Results
+    // are sized first and written straight into the result value.
+    static std::string_view textOf(const Value& value, std::string& scratch) {
+        if (value.getType() == ValueType::STRING) {
+            return value.getString();
+        }
+        scratch = value.toString();
+        return scratch;
+    }
+    
+    // Missing arguments read as empty strings
+    static const Value& argOrEmpty(ValueSpan args, size_t index) {
+        static const Value empty;
+        return index < args.size() ? args[index] : empty;
+    }
+    
+    template <BuiltinFunction1 Fn>
+    static void spanEntry(ValueSpan args, Value& result) {
+        Fn(argOrEmpty(args, 0), result);
+    }
+    
+    template <BuiltinFunction2 Fn>
+    static void spanEntry(ValueSpan args, Value& result) {
+        Fn(argOrEmpty(args, 0), argOrEmpty(args, 1), result);
+    }
+    
+    template <BuiltinFunction3 Fn>
+    static void spanEntry(ValueSpan args, Value& result) {
+        Fn(argOrEmpty(args, 0), argOrEmpty(args, 1), argOrEmpty(args, 2), result);
+    }
+    
+    // Pure builtin with a fixed arity taken from Fn, plus its fast entry
+    template <BuiltinFunction1 Fn>
+    void registerPureOp(BuiltinKind kind, const std::string& name) {
+        addFastEntry(registerBuiltin(name, kind, 1, &spanEntry<Fn>, true), Fn);
+    }
+    
+    template <BuiltinFunction2 Fn>
+    void registerPureOp(BuiltinKind kind, const std::string& name) {
+        addFastEntry(registerBuiltin(name, kind, 2, &spanEntry<Fn>, true), Fn);
+    }
+    
+    template <BuiltinFunction3 Fn>
+    void registerPureOp(BuiltinKind kind, const std::string& name) {
+        addFastEntry(registerBuiltin(name, kind, 3, &spanEntry<Fn>, true), Fn);
+    }
+    
+    static void stringFind(const Value& text, const Value& needle, Value& result) {
+        std::string textScratch;
+        std::string needleScratch;
+        size_t at = findString(textOf(text, textScratch), textOf(needle, needleScratch));
+        result = Value(at == kNotFound ? -1.0 : static_cast<double>(at));
+    }
+    
+    static void stringContains(const Value& text, const Value& needle, Value& result) {
+        std::string textScratch;
+        std::string needleScratch;
+        result = Value(containsString(textOf(text, textScratch), textOf(needle, needleScratch)));
+    }
+    
+    static void stringCount(const Value& text, const Value& needle, Value& result) {
+        std::string textScratch;
+        std::string needleScratch;
+        result = Value(static_cast<double>(countString(textOf(text, textScratch), textOf(needle, needleScratch))));
+    }
+    
+    static void stringReplace(const Value& text, const Value& needle, const Value& replacement, Value& result) {
+        std::string textScratch;
+        std::string needleScratch;
+        std::string replacementScratch;
+        std::string_view input = textOf(text, textScratch);
+        std::string_view find = textOf(needle, needleScratch);
+        std::string_view with = textOf(replacement, replacementScratch);
+        if (find.empty() || !containsString(input, find)) {
+            result = text.getType() == ValueType::STRING ? text : Value(input);
+            return;
+        }
+        char* out = result.prepareString(replaceAllSize(input, find, with));
+        replaceAll(input, find, with, out);
+    }
+    
+    static void stringSplit(const Value& text, const Value& delimiter, Value& result) {
+        thread_local std::vector<std::string_view> pieces;
+        std::string textScratch;
+        std::string delimiterScratch;
+        pieces.clear();
+        splitString(textOf(text, textScratch), textOf(delimiter, delimiterScratch), pieces);
+        
+        ArrayRep* array = new ArrayRep();
+        Value out(array);
+        array->reserve(pieces.size());
+        for (std::string_view piece : pieces) {
+            array->appendString(piece);
+        }
+        result = std::move(out);
+    }
+    
+    static void stringTrim(const Value& text, Value& result) {
+        std::string scratch;
+        std::string_view input = textOf(text, scratch);
+        std::string_view trimmed = trimAscii(input);
+        if (trimmed.size() == input.size() && text.getType() == ValueType::STRING) {
+            result = text;
+        } else {
+            result = Value(trimmed);
+        }
+    }
+    
+    static void stringUpper(const Value& text, Value& result) {
+        std::string scratch;
+        std::string_view input = textOf(text, scratch);
+        toUpperAscii(input.data(), input.size(), result.prepareString(input.size()));
+    }
+    
+    static void stringLower(const Value& text, Value& result) {
+        std::string scratch;
+        std::string_view input = textOf(text, scratch);
+        toLowerAscii(input.data(), input.size(), result.prepareString(input.size()));
+    }
+    
+    static void stringValidUtf8(const Value& text, Value& result) {
+        std::string scratch;
+        result = Value(validUtf8(textOf(text, scratch)));
+    }
+    
+    static void stringLength(const Value& text, Value& result) {
+        std::string scratch;
+        result = Value(static_cast<double>(utf8Length(textOf(text, scratch))));
+    }
+    
+    // ================= REGEX BUILTINS =================
+    // An invalid pattern throws.
+    static Regex& compiled(const Value& pattern) {
+        std::string scratch;
+        return RegexCache::forThread().get(textOf(pattern, scratch));
+    }
+    
+    static void regexMatch(const Value& text, const Value& pattern, Value& result) {
+        std::string scratch;
+        result = Value(compiled(pattern).matches(textOf(text, scratch)));
+    }
+    
+    static void regexSearch(const Value& text, const Value& pattern, Value& result) {
+        std::string scratch;
+        RegexMatch match;
+        bool found = compiled(pattern).search(textOf(text, scratch), 0, match);
+        result = Value(found ? static_cast<double>(match.begin) : -1.0);
+    }
+    
+    // An empty match steps one byte forward before searching again, so
+    // every position is tried once
+    static void regexReplace(const Value& text, const Value& pattern, const Value& replacement, Value& result) {
+        Regex& re = compiled(pattern);
+        std::string scratch;
+        std::string replacementScratch;
+        std::string_view input = textOf(text, scratch);
+        std::string_view with = textOf(replacement, replacementScratch);
+        
+        RegexMatch match;
+        if (!re.search(input, 0, match)) {
+            result = text.getType() == ValueType::STRING ? text : Value(input);
+            return;
+        }
+        std::string out;
+        size_t copied = 0;
+        do {
+            out.append(input.data() + copied, match.begin - copied);
+            out.append(with.data(), with.size());
+            copied = match.end;
+        } while (re.search(input, match.end > match.begin ? match.end : match.end + 1, match));
+        out.append(input.data() + copied, input.size() - copied);
+        result = Value(out);
+    }
+    
+    static void regexSplit(const Value& text, const Value& pattern, Value& result) {
+        Regex& re = compiled(pattern);
+        std::string scratch;
+        std::string_view input = textOf(text, scratch);
+        
+        ArrayRep* pieces = new ArrayRep();
+        Value out(pieces);
+        RegexMatch match;
+        size_t pos = 0;
+        size_t pieceStart = 0;
+        while (re.search(input, pos, match)) {
+            pieces->appendString(input.substr(pieceStart, match.begin - pieceStart));
+            pieceStart = match.end;
+            pos = match.end > match.begin ? match.end : match.end + 1;
+        }
+        pieces->appendString(input.substr(pieceStart));
+        result = std::move(out);
+    }
+    
+    // ================= BATCH BUILTINS =================
+    // Operands must be FLOAT arrays; anything else yields an empty value.
+    // Element-wise operands must have the same length.
+    using BinaryKernel = void (*SimdKernels::*)(const double*, const double*, double*, size_t);
+    using ReduceKernel = double (*SimdKernels::*)(const double*, size_t);
+    
+    static const ArrayRep* floatArray(const Value& value) {
+        if (value.getType() != ValueType::ARRAY || value.getArray().layout() != ArrayRep::Layout::FLOAT) {
+            return nullptr;
+        }
+        return &value.getArray();
+    }
+    
+    static void requireSameLength(const ArrayRep& a, const ArrayRep& b) {
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Batch operands must have the same length");
+        }
+    }
+    
+    // Fresh FLOAT array of n elements for a kernel to fill
+    static double* newFloatArray(size_t n, Value& result) {
+        ArrayRep* array = new ArrayRep();
+        array->floatStorage().resize(n);
+        result = Value(array);
+        return array->floatStorage().data();
+    }
+    
+    void registerBinaryBatch(const std::string& name, IrOp op, BuiltinFunction2 fixed, BuiltinFunction span,
+                             IrType resultType = IrType::FLOAT_ARRAY) {
+        BuiltinId id = registerBuiltin(name, BuiltinKind::SIMD_OP, 2, span, true);
+        addFastEntry(id, fixed);
+        setIntrinsic(id, lowering(op, IrType::FLOAT_ARRAY, resultType));
+    }
+    
+    template <BinaryKernel Kernel>
+    static void batchBinary(const Value& a, const Value& b, Value& result) {
+        const ArrayRep* x = floatArray(a);
+        const ArrayRep* y = floatArray(b);
+        if (!x || !y) {
+            result = Value();
+            return;
+        }
+        requireSameLength(*x, *y);
+        Value out;
+        double* data = newFloatArray(x->size(), out);
+        (simdKernels().*Kernel)(x->floatData(), y->floatData(), data, x->size());
+        result = std::move(out);
+    }
+    
+    template <BinaryKernel Kernel>
+    static void batchBinarySpan(ValueSpan args, Value& result) {
+        result = Value();
+        if (args.size() >= 2) {
+            batchBinary<Kernel>(args[0], args[1], result);
+        }
+    }
+    
+    // Element-wise comparison as a 1/0 mask array
+    template <CompareOp Op>
+    static void batchCompare(const Value& a, const Value& b, Value& result) {
+        const ArrayRep* x = floatArray(a);
+        const ArrayRep* y = floatArray(b);
+        if (!x || !y) {
+            result = Value();
+            return;
+        }
+        requireSameLength(*x, *y);
+        Value out;
+        double* data = newFloatArray(x->size(), out);
+        simdKernels().compare(x->floatData(), y->floatData(), data, x->size(), Op);
+        result = std::move(out);
+    }
+    
+    template <CompareOp Op>
+    static void batchCompareSpan(ValueSpan args, Value& result) {
+        result = Value();
+        if (args.size() >= 2) {
+            batchCompare<Op>(args[0], args[1], result);
+        }
+    }
+    
+    static void batchFma(const Value& a, const Value& b, const Value& c, Value& result) {
+        const ArrayRep* x = floatArray(a);
+        const ArrayRep* y = floatArray(b);
+        const ArrayRep* z = floatArray(c);
+        if (!x || !y || !z) {
+            result = Value();
+            return;
+        }
+        requireSameLength(*x, *y);
+        requireSameLength(*x, *z);
+        Value out;
+        double* data = newFloatArray(x->size(), out);
+        simdKernels().fma(x->floatData(), y->floatData(), z->floatData(), data, x->size());
+        result = std::move(out);
+    }
+    
+    static void batchDot(const Value& a, const Value& b, Value& result) {
+        const ArrayRep* x = floatArray(a);
+        const ArrayRep* y = floatArray(b);
+        if (!x || !y) {
+            result = Value();
+            return;
+        }
+        requireSameLength(*x, *y);
+        result = Value(simdKernels().dot(x->floatData(), y->floatData(), x->size()));
+    }
+    
+    // Sum of an empty array is 0; its min and max are empty values
+    template <ReduceKernel Kernel>
+    static void batchReduce(const Value& a, Value& result) {
+        const ArrayRep* x = floatArray(a);
+        if (!x || (x->empty() && Kernel != &SimdKernels::sum)) {
+            result = Value();
+            return;
+        }
+        result = Value(x->empty() ? 0.0 : (simdKernels().*Kernel)(x->floatData(), x->size()));
+    }
+    
+    template <ReduceKernel Kernel>
+    static void batchReduceSpan(ValueSpan args, Value& result) {
+        result = Value();
+        if (!args.empty()) {
+            batchReduce<Kernel>(args[0], result);
+        }
+    }
+    
+    // ================= SORT BUILTINS =================
+    // Sorted copies (arrays are immutable). FLOAT arrays sort numerically,
+    // STRING arrays by bytes; anything else yields an empty value.
+    static std::vector<std::string_view> stringElements(const ArrayRep& array) {
+        std::vector<std::string_view> elements(array.size());
+        for (size_t i = 0; i < elements.size(); ++i) {
+            elements[i] = array.stringAt(i);
+        }
+        return elements;
+    }
+    
+    static Value stringArray(const std::string_view* elements, size_t count) {
+        ArrayRep* array = new ArrayRep();
+        Value out(array);
+        array->reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            array->appendString(elements[i]);
+        }
+        return out;
+    }
+    
+    static void sortArray(const Value& array, Value& result) {
+        if (array.getType() != ValueType::ARRAY) {
+            result = Value();
+            return;
+        }
+        const ArrayRep& source = array.getArray();
+        Value out;
+        if (source.layout() == ArrayRep::Layout::FLOAT) {
+            double* data = newFloatArray(source.size(), out);
+            std::copy(source.floatData(), source.floatData() + source.size(), data);
+            sortFloats(data, source.size());
+        } else {
+            std::vector<std::string_view> elements = stringElements(source);
+            sortStrings(elements.data(), elements.size());
+            out = stringArray(elements.data(), elements.size());
+        }
+        result = std::move(out);
+    }
+    
+    template <bool Stable>
+    static void sortBy(const Value& array, const Value& keys, Value& result) {
+        if (array.getType() != ValueType::ARRAY || keys.getType() != ValueType::ARRAY) {
+            result = Value();
+            return;
+        }
+        const ArrayRep& source = array.getArray();
+        const ArrayRep& keyArray = keys.getArray();
+        size_t n = source.size();
+        if (keyArray.size() != n) {
+            throw std::runtime_error("Sort keys must have the same length as the array");
+        }
+        
+        std::vector<size_t> order(n);
+        if (keyArray.layout() == ArrayRep::Layout::FLOAT) {
+            std::vector<FloatSortEntry> entries(n);
+            for (size_t i = 0; i < n; ++i) {
+                entries[i] = FloatSortEntry{floatSortKey(keyArray.floatAt(i)), i};
+            }
+            sortFloatEntries(entries.data(), n);
+            for (size_t i = 0; i < n; ++i) order[i] = entries[i].index;
+        } else {
+            std::vector<StringSortEntry> entries(n);
+            for (size_t i = 0; i < n; ++i) {
+                entries[i] = StringSortEntry{keyArray.stringAt(i), i};
+            }
+            sortStringEntries(entries.data(), n, Stable);
+            for (size_t i = 0; i < n; ++i) order[i] = entries[i].index;
+        }
+        
+        Value out;
+        if (source.layout() == ArrayRep::Layout::FLOAT) {
+            double* data = newFloatArray(n, out);
+            for (size_t i = 0; i < n; ++i) {
+                data[i] = source.floatAt(order[i]);
+            }
+        } else {
+            ArrayRep* sorted = new ArrayRep();
+            out = Value(sorted);
+            sorted->reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                sorted->appendString(source.stringAt(order[i]));
+            }
+        }
+        result = std::move(out);
+    }
+    
+    static void sortTopK(const Value& array, const Value& count, Value& result) {
+        if (array.getType() != ValueType::ARRAY) {
+            result = Value();
+            return;
+        }
+        const ArrayRep& source = array.getArray();
+        size_t n = source.size();
+        double requested = count.toFloat();
+        size_t k = requested > 0 ? static_cast<size_t>(std::min(requested, static_cast<double>(n))) : 0;
+        Value out;
+        if (source.layout() == ArrayRep::Layout::FLOAT) {
+            std::vector<double> values(source.floatData(), source.floatData() + n);
+            topFloats(values.data(), n, k);
+            double* data = newFloatArray(k, out);
+            std::copy(values.begin(), values.begin() + k, data);
+        } else {
+            std::vector<std::string_view> elements = stringElements(source);
+            topStrings(elements.data(), n, k);
+            out = stringArray(elements.data(), k);
+        }
+        result = std::move(out);
+    }
+    
+    // ================= TABLE BUILTINS =================
+    // Operations return new tables (sharing unchanged columns); a first
+    // argument that is not a table yields an empty value. Column names and
+    // operator names are read as strings.
+    static const TableRep* tableOf(const Value& value) {
+        return value.getType() == ValueType::TABLE ? &value.getTable() : nullptr;
+    }
+    
+    static void createTable(ValueSpan args, Value& result) {
+        if (args.size() % 2 != 0) {
+            throw std::runtime_error("Create_Table expects column name and array pairs");
+        }
+        std::vector<std::string> names;
+        std::vector<const ArrayRep*> arrays;
+        for (size_t i = 0; i < args.size(); i += 2) {
+            if (args[i + 1].getType() != ValueType::ARRAY) {
+                throw std::runtime_error("Create_Table column '" + args[i].toString() + "' is not an array");
+            }
+            names.push_back(args[i].toString());
+            arrays.push_back(&args[i + 1].getArray());
+        }
+        Value out(tableFromArrays(names, arrays));
+        result = std::move(out);
+    }
+    
+    static void tableFromCsvText(const Value& text, Value& result) {
+        std::string scratch;
+        Value out(tableFromCsv(textOf(text, scratch)));
+        result = std::move(out);
+    }
+    
+    static void tableRows(const Value& table, Value& result) {
+        const TableRep* rep = tableOf(table);
+        result = Value(rep ? static_cast<double>(rep->rows) : 0.0);
+    }
+    
+    static void tableColumns(const Value& table, Value& result) {
+        const TableRep* rep = tableOf(table);
+        if (!rep) {
+            result = Value();
+            return;
+        }
+        ArrayRep* names = new ArrayRep();
+        Value out(names);
+        names->reserve(rep->names.size());
+        for (const std::string& name : rep->names) {
+            names->appendString(name);
+        }
+        result = std::move(out);
+    }
+    
+    static void tableColumn(const Value& table, const Value& column, Value& result) {
+        const TableRep* rep = tableOf(table);
+        if (!rep) {
+            result = Value();
+            return;
+        }
+        std::string scratch;
+        Value out(columnToArray(rep->column(textOf(column, scratch))));
+        result = std::move(out);
+    }
+    
+    // Nulls read as empty values
+    static void tableGet(const Value& table, const Value& row, const Value& column, Value& result) {
+        const TableRep* rep = tableOf(table);
+        if (!rep) {
+            result = Value();
+            return;
+        }
+        std::string scratch;
+        const Column& values = rep->column(textOf(column, scratch));
+        double index = row.toFloat();
+        if (!(index >= 0) || index >= static_cast<double>(rep->rows)) {
+            throw std::runtime_error("Table row out of range");
+        }
+        size_t at = static_cast<size_t>(index);
+        Value out;
+        if (!values.isNull(at)) {
+            out = values.type == Column::Type::FLOAT ? Value(values.numbers[at]) : Value(values.stringAt(at));
+        }
+        result = std::move(out);
+    }
+    
+    static void tableSelect(ValueSpan args, Value& result) {
+        const TableRep* rep = args.empty() ? nullptr : tableOf(args[0]);
+        if (!rep) {
+            result = Value();
+            return;
+        }
+        std::vector<std::string> scratch(args.size());
+        std::vector<std::string_view> names;
+        for (size_t i = 1; i < args.size(); ++i) {
+            names.push_back(textOf(args[i], scratch[i]));
+        }
+        Value out(selectColumns(*rep, names));
+        result = std::move(out);
+    }
+    
+    static void tableFilter(ValueSpan args, Value& result) {
+        const TableRep* rep = args.empty() ? nullptr : tableOf(args[0]);
+        if (!rep) {
+            result = Value();
+            return;
+        }
+        std::string columnScratch;
+        std::string opScratch;
+        std::string operandScratch;
+        const Value& operandValue = argOrEmpty(args, 3);
+        FilterOperand operand;
+        operand.text = textOf(operandValue, operandScratch);
+        operand.isNumber = operandValue.tryGetNumber(operand.number);
+        FilterOp op = parseFilterOp(textOf(argOrEmpty(args, 2), opScratch));
+        Value out(filterRows(*rep, textOf(argOrEmpty(args, 1), columnScratch), op, operand));
+        result = std::move(out);
+    }
+    
+    // Aggregates over no values (min, max, avg) are empty values
+    static void tableAggregate(const Value& table, const Value& column, const Value& op, Value& result) {
+        const TableRep* rep = tableOf(table);
+        if (!rep) {
+            result = Value();
+            return;
+        }
+        std::string columnScratch;
+        std::string opScratch;
+        AggregateResult aggregate = aggregateColumn(*rep, textOf(column, columnScratch),
+                                                    parseAggregateOp(textOf(op, opScratch)));
+        Value out;
+        if (aggregate.kind == AggregateResult::Kind::NUMBER) {
+            out = Value(aggregate.number);
+        } else if (aggregate.kind == AggregateResult::Kind::TEXT) {
+            out = Value(aggregate.text);
+        }
+        result = std::move(out);
+    }
+    
+    static void tableGroupBy(ValueSpan args, Value& result) {
+        const TableRep* rep = args.empty() ? nullptr : tableOf(args[0]);
+        if (!rep) {
+            result = Value();
+            return;
+        }
+        std::string keyScratch;
+        std::string columnScratch;
+        std::string opScratch;
+        Value out(groupRows(*rep, textOf(argOrEmpty(args, 1), keyScratch), textOf(argOrEmpty(args, 2), columnScratch),
+                            parseAggregateOp(textOf(argOrEmpty(args, 3), opScratch))));
+        result = std::move(out);
     }
-
-private:
-    std::unordered_map<std::string, std::unique_ptr<Builtin>> builtins_;
     
     // Private constructor for singleton
     BuiltinsRegistry() {
+        auto initial = std::make_unique<Table>();
+        initial_ = initial.get();
         initializeBuiltins();
+        initial_ = nullptr;
+        table_.publish(std::move(initial));
     }
     
     // Delete copy constructor and assignment operator
@@ -0,0 +1,104 @@
+/* NexLang native builtin plugin interface (C ABI).
+ *
+ * A plugin is a shared object exporting
+ *
+ *     int nexlang_plugin_init(const NexHostApi* api, NexHost* host);
+ *
+ * The host calls it once after dlopen. The plugin registers its builtins
+ * with api->registerBuiltin and returns 0, or non-zero to reject loading.
+ * Plugins must check api->abiVersion before using the table; fields are only
+ * ever appended, so a newer host serves older plugins unchanged.
+ *
+ * Values are opaque. Arguments arrive as a contiguous array reached through
+ * api->arg; the result is written with the api->set* functions.
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NEXLANG_PLUGIN_ABI_VERSION 1u
+#define NEXLANG_PLUGIN_INIT_SYMBOL "nexlang_plugin_init"
+
+typedef struct NexValue NexValue;
+typedef struct NexHost NexHost;
+typedef struct NexHostApi NexHostApi;
+
+typedef enum NexValueType {
+    NEX_VALUE_STRING = 0,
+    NEX_VALUE_FLOAT = 1,
+    NEX_VALUE_BOOL = 2,
+    NEX_VALUE_HANDLE = 3,
+    NEX_VALUE_ARRAY = 4,
+    NEX_VALUE_TABLE = 5
+} NexValueType;
+
+/* Builtin categories; same order as BuiltinKind */
+typedef enum NexBuiltinKind {
+    NEX_BUILTIN_SAY = 0,
+    NEX_BUILTIN_OPEN_FILE = 1,
+    NEX_BUILTIN_READ_FILE = 2,
+    NEX_BUILTIN_WRITE_FILE = 3,
+    NEX_BUILTIN_MATH_OP = 4,
+    NEX_BUILTIN_STRING_OP = 5,
+    NEX_BUILTIN_REGEX_OP = 6,
+    NEX_BUILTIN_FILE_OP = 7,
+    NEX_BUILTIN_NETWORK_OP = 8,
+    NEX_BUILTIN_SIMD_OP = 9,
+    NEX_BUILTIN_ARRAY_OP = 10,
+    NEX_BUILTIN_TABLE_OP = 11
+} NexBuiltinKind;
+
+/* Flags for NexBuiltinDesc.flags */
+#define NEX_BUILTIN_PURE 0x1u   /* no side effects; result depends only on the arguments */
+
+/* A native builtin. args points at argc values (use api->arg to index);
+ * result must be set before returning. Errors are reported with
+ * api->raiseError followed by a return. */
+typedef void (*NexBuiltinFn)(const NexValue* args, size_t argc, NexValue* result,
+                             const NexHostApi* api);
+
+typedef struct NexBuiltinDesc {
+    const char* name;
+    uint32_t kind;       /* NexBuiltinKind */
+    int32_t argCount;    /* -1 for variable arguments */
+    uint32_t flags;      /* NEX_BUILTIN_* */
+    NexBuiltinFn fn;
+} NexBuiltinDesc;
+
+struct NexHostApi {
+    uint32_t abiVersion;   /* NEXLANG_PLUGIN_ABI_VERSION of the host */
+    uint32_t size;         /* sizeof(NexHostApi) of the host */
+
+    /* Registration (only valid during nexlang_plugin_init); returns 0 on success */
+    int (*registerBuiltin)(NexHost* host, const NexBuiltinDesc* desc);
+
+    /* Reading values */
+    const NexValue* (*arg)(const NexValue* args, size_t index);
+    NexValueType (*typeOf)(const NexValue* value);
+    double (*toFloat)(const NexValue* value);
+    int (*toBool)(const NexValue* value);
+    /* Text of a STRING value (NULL otherwise); valid while the argument is */
+    const char* (*stringData)(const NexValue* value, size_t* length);
+    /* Elements of a FLOAT-layout ARRAY value (NULL otherwise) */
+    const double* (*floatArrayData)(const NexValue* value, size_t* length);
+
+    /* Writing the result */
+    void (*setFloat)(NexValue* result, double value);
+    void (*setBool)(NexValue* result, int value);
+    void (*setString)(NexValue* result, const char* data, size_t length);
+    /* New FLOAT array of length elements stored in result; fill the returned buffer */
+    double* (*newFloatArray)(NexValue* result, size_t length);
+
+    /* Abort the call with an error (the host throws once the builtin returns) */
+    void (*raiseError)(const char* message);
+};
+
+typedef int (*NexPluginInitFn)(const NexHostApi* api, NexHost* host);
+
+#ifdef __cplusplus
+}
+#endif
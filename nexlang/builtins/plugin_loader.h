@@ -0,0 +1,273 @@
+#pragma once
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "plugin_api.h"
+#include "builtins_registry.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+// ================= NATIVE PLUGINS =================
+// Loads shared objects implementing plugin_api.h and registers their
+// builtins with the BuiltinsRegistry. Plugins are loaded at startup, before
+// the analyzer resolves any names, and stay loaded for the life of the
+// process. A NexValue* handed to a plugin is a Value* in disguise.
+
+class PluginLoader {
+public:
+    static PluginLoader& getInstance() {
+        static PluginLoader instance;
+        return instance;
+    }
+
+    // Load one plugin and register its builtins; returns their names
+    std::vector<std::string> load(const std::string& path) {
+        void* library = openLibrary(path);
+        if (!library) {
+            throw std::runtime_error("Cannot load plugin '" + path + "': " + lastError());
+        }
+
+        NexPluginInitFn init = reinterpret_cast<NexPluginInitFn>(findSymbol(library, NEXLANG_PLUGIN_INIT_SYMBOL));
+        if (!init) {
+            closeLibrary(library);
+            throw std::runtime_error("Plugin '" + path + "' does not export " NEXLANG_PLUGIN_INIT_SYMBOL);
+        }
+
+        LoadContext context{path, {}};
+        if (init(&hostApi(), reinterpret_cast<NexHost*>(&context)) != 0) {
+            // Builtins it registered before failing keep pointers into the
+            // library, so it stays loaded either way
+            libraries_.push_back(library);
+            throw std::runtime_error("Plugin '" + path + "' failed to initialise");
+        }
+        libraries_.push_back(library);
+        return context.names;
+    }
+
+    // Load every plugin listed in NEXLANG_PLUGINS (separated like PATH)
+    void loadFromEnvironment() {
+        const char* list = std::getenv("NEXLANG_PLUGINS");
+        if (!list) {
+            return;
+        }
+#ifdef _WIN32
+        const char separator = ';';
+#else
+        const char separator = ':';
+#endif
+        std::string paths(list);
+        size_t start = 0;
+        while (start <= paths.size()) {
+            size_t end = paths.find(separator, start);
+            if (end == std::string::npos) end = paths.size();
+            if (end > start) {
+                load(paths.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+    }
+
+    size_t loadedCount() const {
+        return libraries_.size();
+    }
+
+private:
+    std::vector<void*> libraries_;   // never closed; registered builtins point into them
+
+    PluginLoader() = default;
+
+    // ================= HOST API =================
+    static const Value& value(const NexValue* v) {
+        return *reinterpret_cast<const Value*>(v);
+    }
+
+    static Value& value(NexValue* v) {
+        return *reinterpret_cast<Value*>(v);
+    }
+
+    // Library being initialised; handed to the plugin as its NexHost
+    struct LoadContext {
+        std::string path;
+        std::vector<std::string> names;
+    };
+
+    // The callbacks below are called from the plugin's C frames, so no
+    // exception may leave them: a failure is reported like raiseError and
+    // the call returns an empty answer.
+    static void reportFailure(const char* message) noexcept {
+        try {
+            std::string& error = BuiltinsRegistry::nativeError();
+            if (error.empty()) {
+                error = message;
+            }
+        } catch (...) {
+        }
+    }
+
+    static int registerBuiltin(NexHost* host, const NexBuiltinDesc* desc) noexcept {
+        if (!host || !desc || !desc->name || !desc->fn ||
+            desc->kind > NEX_BUILTIN_TABLE_OP || desc->argCount < -1) {
+            return -1;
+        }
+        try {
+            LoadContext* context = reinterpret_cast<LoadContext*>(host);
+            BuiltinsRegistry::getInstance().registerNative(desc->name, static_cast<BuiltinKind>(desc->kind),
+                                                           desc->argCount, (desc->flags & NEX_BUILTIN_PURE) != 0,
+                                                           desc->fn, &hostApi());
+            context->names.push_back(desc->name);
+            return 0;
+        } catch (...) {
+            return -1;
+        }
+    }
+
+    static const NexValue* arg(const NexValue* args, size_t index) noexcept {
+        return reinterpret_cast<const NexValue*>(reinterpret_cast<const Value*>(args) + index);
+    }
+
+    static NexValueType typeOf(const NexValue* v) noexcept {
+        return static_cast<NexValueType>(value(v).getType());
+    }
+
+    // Reading a string may flatten a rope or parse it, which can throw
+    static double toFloat(const NexValue* v) noexcept {
+        try {
+            return value(v).toFloat();
+        } catch (const std::exception& error) {
+            reportFailure(error.what());
+            return 0.0;
+        }
+    }
+
+    static int toBool(const NexValue* v) noexcept {
+        try {
+            return value(v).toBool() ? 1 : 0;
+        } catch (const std::exception& error) {
+            reportFailure(error.what());
+            return 0;
+        }
+    }
+
+    static const char* stringData(const NexValue* v, size_t* length) noexcept {
+        try {
+            const Value& text = value(v);
+            if (text.getType() != ValueType::STRING) {
+                return nullptr;
+            }
+            std::string_view view = text.getString();
+            if (length) *length = view.size();
+            return view.data();
+        } catch (const std::exception& error) {
+            reportFailure(error.what());
+            return nullptr;
+        }
+    }
+
+    static const double* floatArrayData(const NexValue* v, size_t* length) noexcept {
+        const Value& array = value(v);
+        if (array.getType() != ValueType::ARRAY || array.getArray().layout() != ArrayRep::Layout::FLOAT) {
+            return nullptr;
+        }
+        if (length) *length = array.getArray().size();
+        return array.getArray().floatData();
+    }
+
+    static void setFloat(NexValue* result, double f) noexcept {
+        try {
+            value(result) = Value(f);
+        } catch (const std::exception& error) {
+            reportFailure(error.what());
+        }
+    }
+
+    static void setBool(NexValue* result, int b) noexcept {
+        try {
+            value(result) = Value(b != 0);
+        } catch (const std::exception& error) {
+            reportFailure(error.what());
+        }
+    }
+
+    static void setString(NexValue* result, const char* data, size_t length) noexcept {
+        try {
+            value(result) = Value(std::string_view(data, length));
+        } catch (const std::exception& error) {
+            reportFailure(error.what());
+        }
+    }
+
+    // nullptr (with the error reported) if the array cannot be allocated
+    static double* newFloatArray(NexValue* result, size_t length) noexcept {
+        try {
+            ArrayRep* array = new ArrayRep();
+            Value wrapped(array);
+            array->floatStorage().resize(length);
+            value(result) = std::move(wrapped);
+            return array->floatStorage().data();
+        } catch (const std::exception& error) {
+            reportFailure(error.what());
+            return nullptr;
+        }
+    }
+
+    static void raiseError(const char* message) noexcept {
+        try {
+            BuiltinsRegistry::nativeError() = (message && *message) ? message : "native builtin failed";
+        } catch (...) {
+        }
+    }
+
+    static const NexHostApi& hostApi() {
+        static const NexHostApi table = {
+            NEXLANG_PLUGIN_ABI_VERSION,
+            static_cast<uint32_t>(sizeof(NexHostApi)),
+            &registerBuiltin,
+            &arg,
+            &typeOf,
+            &toFloat,
+            &toBool,
+            &stringData,
+            &floatArrayData,
+            &setFloat,
+            &setBool,
+            &setString,
+            &newFloatArray,
+            &raiseError,
+        };
+        return table;
+    }
+
+#ifdef _WIN32
+    static void* openLibrary(const std::string& path) {
+        return reinterpret_cast<void*>(LoadLibraryA(path.c_str()));
+    }
+    static void* findSymbol(void* library, const char* name) {
+        return reinterpret_cast<void*>(GetProcAddress(reinterpret_cast<HMODULE>(library), name));
+    }
+    static void closeLibrary(void* library) {
+        FreeLibrary(reinterpret_cast<HMODULE>(library));
+    }
+    static std::string lastError() {
+        return "error " + std::to_string(GetLastError());
+    }
+#else
+    static void* openLibrary(const std::string& path) {
+        return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+    static void* findSymbol(void* library, const char* name) {
+        return dlsym(library, name);
+    }
+    static void closeLibrary(void* library) {
+        dlclose(library);
+    }
+    static std::string lastError() {
+        const char* error = dlerror();
+        return error ? error : "unknown error";
+    }
+#endif
+};
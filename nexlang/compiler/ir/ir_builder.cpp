@@ -1,3 +1,84 @@
-// Placeholder for IR builder implementation
+// IR builder implementation
+#include "ir_builder.h"
+#include <exception>
 
-// Implement IR builder logic here
+IrValueId IrBuilder::constant(Value value) {
+    IrInstr instr;
+    instr.op = IrOp::CONST;
+    instr.type = irTypeOf(value);
+    instr.constant = static_cast<uint32_t>(function_.constants.size());
+    function_.constants.push_back(std::move(value));
+    return emit(std::move(instr));
+}
+
+IrValueId IrBuilder::callBuiltin(BuiltinId id, const std::vector<IrValueId>& args) {
+    const Builtin& builtin = BuiltinsRegistry::getInstance().builtin(id);
+
+    Value folded;
+    if (tryFold(builtin, args, folded)) {
+        return constant(std::move(folded));
+    }
+
+    if (canLower(builtin, args)) {
+        IrInstr instr;
+        instr.op = builtin.intrinsic.op;
+        instr.type = builtin.intrinsic.resultType;
+        instr.operands = args;
+        return emit(std::move(instr));
+    }
+
+    // Without the lowering's operand types the result type is not known
+    // either (a batch builtin given a STRING array returns an empty value)
+    return call(id, args);
+}
+
+IrValueId IrBuilder::call(BuiltinId id, const std::vector<IrValueId>& args, IrType type) {
+    IrInstr instr;
+    instr.op = IrOp::CALL_BUILTIN;
+    instr.type = type;
+    instr.builtin = id;
+    instr.operands = args;
+    return emit(std::move(instr));
+}
+
+IrValueId IrBuilder::emit(IrInstr instr) {
+    function_.instrs.push_back(std::move(instr));
+    return static_cast<IrValueId>(function_.instrs.size() - 1);
+}
+
+bool IrBuilder::tryFold(const Builtin& builtin, const std::vector<IrValueId>& args, Value& result) const {
+    if (!builtin.isConst()) {
+        return false;
+    }
+    std::vector<Value> values;
+    values.reserve(args.size());
+    for (IrValueId arg : args) {
+        if (!isConstant(arg)) {
+            return false;
+        }
+        values.push_back(constantValue(arg));
+    }
+
+    // Errors (e.g. Divide by zero) must surface when the program runs,
+    // whatever exception type the builtin uses
+    try {
+        BuiltinsRegistry::getInstance().call(builtin.id, ValueSpan(values), result);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+bool IrBuilder::canLower(const Builtin& builtin, const std::vector<IrValueId>& args) const {
+    const Intrinsic& intrinsic = builtin.intrinsic;
+    if (intrinsic.op == IrOp::CALL_BUILTIN ||
+        static_cast<int>(args.size()) != builtin.argCount) {
+        return false;
+    }
+    for (IrValueId arg : args) {
+        if (function_.def(arg).type != intrinsic.operandType) {
+            return false;
+        }
+    }
+    return true;
+}
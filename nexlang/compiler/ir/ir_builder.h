@@ -0,0 +1,41 @@
+// Header for the IR builder
+#pragma once
+#include <vector>
+#include "ir_ops.h"
+#include "../../builtins/builtins_registry.h"
+
+// ================= IR BUILDER =================
+// Appends instructions to an IrFunction. Builtin calls are specialised
+// using the builtin's Intrinsic:
+//   - a const builtin whose arguments are all constants is evaluated now
+//     and becomes a CONST (calls that throw are left for run time)
+//   - a builtin with a direct lowering becomes that op when every operand
+//     is known to have the lowering's operand type (FLOAT_ARRAY for vector
+//     ops: an ARRAY of unknown layout stays a call)
+//   - anything else is a CALL_BUILTIN through the registry
+class IrBuilder {
+public:
+    explicit IrBuilder(IrFunction& function) : function_(function) {}
+
+    IrValueId constant(Value value);
+
+    IrValueId callBuiltin(BuiltinId id, const std::vector<IrValueId>& args);
+
+    // Plain call, never folded or lowered
+    IrValueId call(BuiltinId id, const std::vector<IrValueId>& args, IrType type = IrType::UNKNOWN);
+
+    bool isConstant(IrValueId value) const {
+        return function_.def(value).op == IrOp::CONST;
+    }
+
+    const Value& constantValue(IrValueId value) const {
+        return function_.constants[function_.def(value).constant];
+    }
+
+private:
+    IrFunction& function_;
+
+    IrValueId emit(IrInstr instr);
+    bool tryFold(const Builtin& builtin, const std::vector<IrValueId>& args, Value& result) const;
+    bool canLower(const Builtin& builtin, const std::vector<IrValueId>& args) const;
+};
@@ -1,4 +1,25 @@
-// Placeholder for IR operations header
+// IR operations header
 #pragma once
+#include <cstdint>
+#include <vector>
+#include "../../runtime/value.h"
+#include "../../runtime/intrinsic_ops.h"
 
-// Define IR operation enums, structs, etc. here
+// ================= IR FUNCTION =================
+using IrValueId = uint32_t;
+
+// Instruction i of a function defines value i
+struct IrInstr {
+    IrOp op;
+    IrType type;                        // result type
+    uint16_t builtin = UINT16_MAX;      // BuiltinId, for CALL_BUILTIN
+    uint32_t constant = 0;              // index into constants, for CONST
+    std::vector<IrValueId> operands;
+};
+
+struct IrFunction {
+    std::vector<IrInstr> instrs;
+    std::vector<Value> constants;
+
+    const IrInstr& def(IrValueId value) const { return instrs[value]; }
+};
@@ -3,10 +3,15 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <optional>
 #include <iostream>
+#include <stdexcept>
 #include "../perser/ast.h"
 #include "../runtime/value.h"
+#include "../runtime/float_ops.h"
 #include "../symbol/symbol_table.h"
+#include "../symbol/global_symbol_table.h"
 #include "../builtins/builtins_registry.h"
 
 using namespace std;
@@ -14,6 +19,7 @@ using namespace std;
 // ================= BLOCK EXECUTION CONTEXT =================
 struct ExecutionContext {
     std::shared_ptr<SymbolTable> symbolTable;
+    std::shared_ptr<GlobalSymbolTable> globals;  // shared read-only with other blocks
     std::vector<Value> stack;
     
     ExecutionContext() : symbolTable(std::make_shared<SymbolTable>()) {}
@@ -27,9 +33,15 @@ public:
         BuiltinsRegistry::getInstance();
     }
     
+    // Global symbols from semantic analysis; safe to share across threads
+    void setGlobals(std::shared_ptr<GlobalSymbolTable> globalSymbols) {
+        globals = std::move(globalSymbols);
+    }
+    
     // Execute a program block
     Value executeProgram(std::unique_ptr<ProgramBlock> program) {
         ExecutionContext ctx;
+        ctx.globals = globals;
         
         // Process each section in the program
         for (auto& section : program->sections) {
@@ -50,7 +62,10 @@ public:
     }
 
 private:
+    std::shared_ptr<GlobalSymbolTable> globals;
+    
     void executeDataBlock(ExecutionContext& ctx, DataBlock* dataBlock) {
+        HandleScope handles;  // closes handles opened by this block on exit
         // Execute each statement in the data block
         for (auto& stmt : dataBlock->statements) {
             executeStatement(ctx, stmt.get());
@@ -58,6 +73,7 @@ private:
     }
 
     void executeOperationBlock(ExecutionContext& ctx, OperationBlock* opBlock) {
+        HandleScope handles;
         // Execute each statement in the operation block
         for (auto& stmt : opBlock->body) {
             executeStatement(ctx, stmt.get());
@@ -65,6 +81,7 @@ private:
     }
 
     void executeFunctionBlock(ExecutionContext& ctx, FunctionBlock* funcBlock) {
+        HandleScope handles;
         // Execute each statement in the function block
         for (auto& stmt : funcBlock->body) {
             executeStatement(ctx, stmt.get());
@@ -72,6 +89,7 @@ private:
     }
 
     void executeSystemCallBlock(ExecutionContext& ctx, SystemCallBlock* sysBlock) {
+        HandleScope handles;
         // Execute each statement in the system call block
         for (auto& stmt : sysBlock->body) {
             executeStatement(ctx, stmt.get());
@@ -118,15 +136,15 @@ private:
     void executeLetStatement(ExecutionContext& ctx, LetStmt* stmt) {
         // Convert the value string to a Value object
         Value value;
-        try {
-            double numVal = std::stod(stmt->value);
-            value = Value(numVal);
-        } catch (...) {
+        // Numbers become FLOAT, everything else stays a STRING
+        if (std::optional<double> number = parseFloat(stmt->value)) {
+            value = Value(*number);
+        } else {
             value = Value(stmt->value);
         }
         
         // Define the variable in the current scope
-        ctx.symbolTable->defineVariable(stmt->name, value);
+        ctx.symbolTable->defineVariable(stmt->name, std::move(value));
     }
 
     void executeSayStatement(ExecutionContext& ctx, SayStmt* stmt) {
@@ -142,6 +160,20 @@ private:
     }
 
     void executeRunOperationStatement(ExecutionContext& ctx, RunOperationStmt* stmt) {
+        // Operations are global: resolve through the frozen table shared by
+        // all blocks rather than the block's own scopes
+        if (ctx.globals) {
+            GlobalSymbolTable::Resolved op = ctx.globals->resolve(stmt->operationId);
+            if (!op || op.symbol->type != SymbolType::OPERATION) {
+                throw std::runtime_error("Unknown operation: " + stmt->operationId);
+            }
+            std::cout << "Running operation " << stmt->operationId;
+            for (uint32_t i = 0; i < op.paramCount; ++i) {
+                std::cout << (i == 0 ? " (" : ", ") << StringInterner::getInstance().text(op.params[i]);
+            }
+            std::cout << (op.paramCount ? ")" : "") << std::endl;
+            return;
+        }
         // In a full implementation, this would run the specified operation
         // For now, we'll just log it
         std::cout << "Running operation " << stmt->operationId << std::endl;
@@ -149,16 +181,7 @@ private:
 
     void executeIfStatement(ExecutionContext& ctx, IfStmt* stmt) {
         // Evaluate the condition
-        bool conditionResult = false;
-        
-        // For now, we'll assume the condition is a variable name
-        auto symbol = ctx.symbolTable->lookup(stmt->condition);
-        if (symbol) {
-            conditionResult = symbol->value.toBool();
-        } else {
-            // If it's not a variable, treat it as a string comparison
-            conditionResult = !stmt->condition.empty();
-        }
+        bool conditionResult = evaluateCondition(ctx, stmt->condition);
         
         if (conditionResult) {
             // Execute the then body
@@ -218,11 +241,65 @@ private:
     void executeUntilStatement(ExecutionContext& ctx, UntilStmt* stmt) {
         // For now, we'll just evaluate the condition
         // In a full implementation, this would loop until the condition is met
-        auto symbol = ctx.symbolTable->lookup(stmt->condition);
-        if (symbol) {
-            std::cout << "Until condition evaluated: " << symbol->value.toBool() << std::endl;
-        } else {
-            std::cout << "Until condition: " << stmt->condition << std::endl;
+        std::cout << "Until condition evaluated: " << evaluateCondition(ctx, stmt->condition) << std::endl;
+    }
+    
+    // ================= CONDITIONS =================
+    // A condition is either a comparison ("y = x", "y == 7", "a < b", ...;
+    // a single '=' means equality) evaluated with one Value::compare call,
+    // or a bare operand tested for truthiness. Braces are ignored.
+    bool evaluateCondition(ExecutionContext& ctx, const std::string& condition) {
+        std::string_view text = trimCondition(condition);
+        
+        static const char* const kComparisons[] = {"==", "!=", "<=", ">=", "<", ">", "="};
+        for (const char* op : kComparisons) {
+            size_t pos = text.find(op);
+            if (pos == std::string_view::npos) {
+                continue;
+            }
+            
+            std::string_view opText(op);
+            Value lhs = resolveOperand(ctx, trimCondition(text.substr(0, pos)));
+            Value rhs = resolveOperand(ctx, trimCondition(text.substr(pos + opText.size())));
+            Value::Comparison result = lhs.compare(rhs);
+            
+            if (opText == "<=") return result.lessEqual();
+            if (opText == ">=") return result.greaterEqual();
+            if (opText == "!=") return !result.equal;
+            if (opText == "<")  return result.less;
+            if (opText == ">")  return result.greater();
+            return result.equal;
+        }
+        
+        // No comparison: a variable is tested for truthiness, any other
+        // non-empty text counts as true
+        if (auto symbol = ctx.symbolTable->lookup(StringInterner::getInstance().find(text))) {
+            return symbol->value.toBool();
+        }
+        return !text.empty();
+    }
+    
+    // Variable reference, quoted string literal, or bare number/text
+    Value resolveOperand(ExecutionContext& ctx, std::string_view operand) {
+        if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+            return Value(operand.substr(1, operand.size() - 2));
+        }
+        if (auto symbol = ctx.symbolTable->lookup(StringInterner::getInstance().find(operand))) {
+            return symbol->value;
+        }
+        if (std::optional<double> number = parseFloat(operand)) {
+            return Value(*number);
+        }
+        return Value(operand);
+    }
+    
+    static std::string_view trimCondition(std::string_view text) {
+        const char* const kSkipped = " \t\r\n{}";
+        size_t begin = text.find_first_not_of(kSkipped);
+        if (begin == std::string_view::npos) {
+            return std::string_view();
         }
+        size_t end = text.find_last_not_of(kSkipped);
+        return text.substr(begin, end - begin + 1);
     }
 };
\ No newline at end of file
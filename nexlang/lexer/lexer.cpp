@@ -204,5 +204,10 @@ std::optional<std::string> Lexer::matchOperator() {
 }
 
 Token Lexer::makeToken(TokenType type, const std::string& lex, int line, int col) {
-    return Token{type, lex, line, col};
+    // Names and literals are interned once here; later stages key them by ID
+    SymbolId id = kInvalidSymbolId;
+    if (type == TokenType::Identifier || type == TokenType::Keyword || type == TokenType::String) {
+        id = internString(lex);
+    }
+    return Token{type, lex, line, col, id};
 }
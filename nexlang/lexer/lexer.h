@@ -3,6 +3,7 @@
 #include <string>
 #include <optional>
 #include <memory>
+#include "../symbol/string_interner.h"
 
 // TokenType and Token struct
 
@@ -23,6 +24,7 @@ struct Token {
     std::string lexeme;
     int line;
     int column;
+    SymbolId id = kInvalidSymbolId;  // interned lexeme for identifiers, keywords and strings
 };
 
 class Lexer {
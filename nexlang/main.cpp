@@ -6,6 +6,7 @@
 #include "perser/parser.h"
 #include "analyzer/semantic_analyzer.h"
 #include "engine/block_engine.h"
+#include "builtins/plugin_loader.h"
 
 int main(int argc, char** argv) {
     // Get the input file path from command line arguments
@@ -26,6 +27,9 @@ int main(int argc, char** argv) {
     std::cout << "Parsing file: " << filePath << std::endl;
     
     try {
+        // Native builtins must be registered before names are resolved
+        PluginLoader::getInstance().loadFromEnvironment();
+        
         // 1. Lexical Analysis
         std::cout << "\n--- LEXICAL ANALYSIS ---" << std::endl;
         Lexer lexer(sourceCode);
@@ -72,6 +76,7 @@ int main(int argc, char** argv) {
         // 4. Execution
         std::cout << "\n--- EXECUTION ---" << std::endl;
         BlockEngine engine;
+        engine.setGlobals(analyzer.getGlobals());
         Value result = engine.executeProgram(std::move(execProgram));
         std::cout << "Program execution completed!" << std::endl;
         
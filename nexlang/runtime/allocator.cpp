@@ -0,0 +1,209 @@
+// Runtime allocator implementation
+#include "allocator.h"
+#include <algorithm>
+
+// ================= ARENA =================
+
+Arena::~Arena() {
+    reset();
+    while (first_) {
+        Chunk* next = first_->next;
+        ::operator delete(first_);
+        first_ = next;
+    }
+}
+
+void* Arena::allocateSlow(size_t size, size_t align) {
+    size_t needed = size + align;   // room for worst-case padding
+    Chunk* next = current_ ? current_->next : first_;
+    if (!next || next->size < needed) {
+        size_t chunkSize = std::max(kChunkSize, needed);
+        Chunk* fresh = static_cast<Chunk*>(::operator new(sizeof(Chunk) + chunkSize));
+        fresh->size = chunkSize;
+        fresh->next = next;
+        if (current_) {
+            current_->next = fresh;
+        } else {
+            first_ = fresh;
+        }
+        next = fresh;
+    }
+
+    current_ = next;
+    cursor_ = next->begin();
+    limit_ = cursor_ + next->size;
+    return allocate(size, align);
+}
+
+void Arena::rewind(const Mark& m) {
+    while (finalizers_.size() > m.finalizers) {
+        Finalizer f = finalizers_.back();
+        finalizers_.pop_back();
+        f.destroy(f.object);
+    }
+
+    // Keep standard chunks past the mark for reuse; oversized ones were for
+    // a single large request and are freed
+    Chunk* kept = static_cast<Chunk*>(m.chunk);
+    Chunk** link = kept ? &kept->next : &first_;
+    while (*link) {
+        Chunk* chunk = *link;
+        if (chunk->size > kChunkSize) {
+            *link = chunk->next;
+            ::operator delete(chunk);
+        } else {
+            link = &chunk->next;
+        }
+    }
+
+    if (kept) {
+        current_ = kept;
+        cursor_ = m.cursor;
+        limit_ = kept->begin() + kept->size;
+    } else {
+        current_ = first_;
+        cursor_ = first_ ? first_->begin() : nullptr;
+        limit_ = first_ ? first_->begin() + first_->size : nullptr;
+    }
+}
+
+size_t Arena::bytesInUse() const {
+    size_t total = 0;
+    for (Chunk* chunk = first_; chunk && chunk != current_; chunk = chunk->next) {
+        total += chunk->size;
+    }
+    if (current_) {
+        total += static_cast<size_t>(cursor_ - current_->begin());
+    }
+    return total;
+}
+
+// ================= SIZE-CLASS POOLS =================
+
+namespace {
+
+using FreeBlock = PoolAllocator::FreeBlock;
+
+// Set once this thread's cache has been destroyed. Trivially destructible,
+// so it stays readable while later thread_local destructors free blocks.
+thread_local bool threadCacheDestroyed = false;
+
+// Per-thread free lists; returned to the shared lists when the thread exits
+struct ThreadCache {
+    FreeBlock* heads[PoolAllocator::kClassCount] = {};
+    uint32_t counts[PoolAllocator::kClassCount] = {};
+
+    ~ThreadCache() {
+        for (size_t cls = 0; cls < PoolAllocator::kClassCount; ++cls) {
+            if (!heads[cls]) {
+                continue;
+            }
+            FreeBlock* last = heads[cls];
+            while (last->next) {
+                last = last->next;
+            }
+            PoolAllocator::getInstance().give(cls, heads[cls], last);
+            heads[cls] = nullptr;
+            counts[cls] = 0;
+        }
+        threadCacheDestroyed = true;
+    }
+};
+
+// Null once the thread is exiting and its cache is gone; callers then
+// trade single blocks with the shared lists
+ThreadCache* threadCache() {
+    if (threadCacheDestroyed) {
+        return nullptr;
+    }
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+}  // namespace
+
+void* PoolAllocator::allocate(size_t size) {
+    if (size > kMaxBlock) {
+        return ::operator new(size);
+    }
+    size_t cls = sizeClass(size);
+    ThreadCache* cache = threadCache();
+    if (!cache) {
+        uint32_t taken;
+        return take(cls, 1, taken);
+    }
+    if (!cache->heads[cls]) {
+        cache->heads[cls] = take(cls, kBatch, cache->counts[cls]);
+    }
+    FreeBlock* block = cache->heads[cls];
+    cache->heads[cls] = block->next;
+    --cache->counts[cls];
+    return block;
+}
+
+void PoolAllocator::deallocate(void* p, size_t size) {
+    if (!p) {
+        return;
+    }
+    if (size > kMaxBlock) {
+        ::operator delete(p);
+        return;
+    }
+    size_t cls = sizeClass(size);
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    ThreadCache* cache = threadCache();
+    if (!cache) {
+        give(cls, block, block);
+        return;
+    }
+    block->next = cache->heads[cls];
+    cache->heads[cls] = block;
+
+    // Hand a batch back once this thread holds too many
+    if (++cache->counts[cls] > kCacheLimit) {
+        FreeBlock* first = cache->heads[cls];
+        FreeBlock* last = first;
+        for (uint32_t i = 1; i < kBatch; ++i) {
+            last = last->next;
+        }
+        cache->heads[cls] = last->next;
+        cache->counts[cls] -= kBatch;
+        give(cls, first, last);
+    }
+}
+
+FreeBlock* PoolAllocator::take(size_t cls, uint32_t count, uint32_t& taken) {
+    Central& central = central_[cls];
+    std::lock_guard<std::mutex> lock(central.mutex);
+
+    if (!central.head) {
+        // Carve a new slab into blocks of this class
+        size_t block = blockSize(cls);
+        char* slab = static_cast<char*>(::operator new(kSlabSize));
+        FreeBlock* head = nullptr;
+        for (size_t offset = kSlabSize; offset >= block; offset -= block) {
+            FreeBlock* node = reinterpret_cast<FreeBlock*>(slab + offset - block);
+            node->next = head;
+            head = node;
+        }
+        central.head = head;
+    }
+
+    FreeBlock* first = central.head;
+    FreeBlock* last = first;
+    taken = 1;
+    while (taken < count && last->next) {
+        last = last->next;
+        ++taken;
+    }
+    central.head = last->next;
+    last->next = nullptr;
+    return first;
+}
+
+void PoolAllocator::give(size_t cls, FreeBlock* first, FreeBlock* last) {
+    Central& central = central_[cls];
+    std::lock_guard<std::mutex> lock(central.mutex);
+    last->next = central.head;
+    central.head = first;
+}
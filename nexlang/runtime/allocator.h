@@ -0,0 +1,190 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ================= ARENA =================
+// Bump allocator for data that dies together (a pass's scratch data, AST
+// nodes). Memory comes from 64 KiB chunks and is only given back by
+// rewind()/reset(). Objects with destructors are recorded and destroyed in
+// reverse order when the arena rewinds past them.
+class Arena {
+public:
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    // Position to rewind to; taken with mark()
+    struct Mark {
+        void* chunk;
+        char* cursor;
+        size_t finalizers;
+    };
+
+    Arena() = default;
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor_) + align - 1) & ~(uintptr_t(align) - 1);
+        if (cursor_ && aligned + size <= reinterpret_cast<uintptr_t>(limit_)) {
+            cursor_ = reinterpret_cast<char*>(aligned + size);
+            return reinterpret_cast<void*>(aligned);
+        }
+        return allocateSlow(size, align);
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            finalizers_.push_back({[](void* p) { static_cast<T*>(p)->~T(); }, object});
+        }
+        return object;
+    }
+
+    Mark mark() const {
+        return Mark{current_, cursor_, finalizers_.size()};
+    }
+
+    // Destroy everything allocated since m. Chunks stay with the arena for
+    // reuse, so a rewound arena serves the next block without the heap.
+    void rewind(const Mark& m);
+
+    // Rewind to empty
+    void reset() {
+        rewind(Mark{nullptr, nullptr, 0});
+    }
+
+    // Bytes handed out since construction or the last reset (excluding padding)
+    size_t bytesInUse() const;
+
+private:
+    struct Chunk {
+        Chunk* next;     // next chunk in allocation order
+        size_t size;     // usable bytes after the header
+        char* begin() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    struct Finalizer {
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    Chunk* first_ = nullptr;
+    Chunk* current_ = nullptr;
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+    std::vector<Finalizer> finalizers_;
+
+    void* allocateSlow(size_t size, size_t align);
+};
+
+// STL allocator over an Arena (deallocate is a no-op)
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena& a) : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+// ================= SIZE-CLASS POOLS =================
+// Fixed size classes (16 B .. 2 KiB, powers of two) carved from 64 KiB
+// slabs. Each thread keeps a small cache per class and trades blocks with
+// the shared free lists in batches, so most allocations take no lock.
+// Larger requests go to the global heap. Slabs are never returned.
+class PoolAllocator {
+public:
+    static constexpr size_t kMinBlock = 16;
+    static constexpr size_t kMaxBlock = 2048;
+    static constexpr size_t kClassCount = 8;      // 16, 32, ..., 2048
+    static constexpr size_t kSlabSize = 64 * 1024;
+    static constexpr uint32_t kBatch = 32;        // blocks moved per refill/flush
+    static constexpr uint32_t kCacheLimit = 64;   // cached blocks per class
+
+    // Never destroyed: heap objects may still be released during static
+    // destruction
+    static PoolAllocator& getInstance() {
+        static PoolAllocator* instance = new PoolAllocator();
+        return *instance;
+    }
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    void* allocate(size_t size);
+    // size must be the size passed to allocate()
+    void deallocate(void* p, size_t size);
+
+    static size_t sizeClass(size_t size) {
+        size_t cls = 0;
+        size_t block = kMinBlock;
+        while (block < size) {
+            block <<= 1;
+            ++cls;
+        }
+        return cls;
+    }
+
+    static size_t blockSize(size_t cls) {
+        return kMinBlock << cls;
+    }
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Shared free list of one class
+    struct Central {
+        std::mutex mutex;
+        FreeBlock* head = nullptr;
+    };
+
+    // Called by thread caches: move up to count blocks in or out
+    FreeBlock* take(size_t cls, uint32_t count, uint32_t& taken);
+    void give(size_t cls, FreeBlock* first, FreeBlock* last);
+
+private:
+    Central central_[kClassCount];
+
+    PoolAllocator() = default;
+};
+
+// ================= RUNTIME HEAP =================
+// Storage for runtime heap objects (StringRep). Building with
+// NEXLANG_POOLED_ALLOCATION routes them through the size-class pools;
+// otherwise they use the global heap.
+inline void* runtimeAllocate(size_t size) {
+#ifdef NEXLANG_POOLED_ALLOCATION
+    return PoolAllocator::getInstance().allocate(size);
+#else
+    return ::operator new(size);
+#endif
+}
+
+inline void runtimeDeallocate(void* p, size_t size) {
+#ifdef NEXLANG_POOLED_ALLOCATION
+    PoolAllocator::getInstance().deallocate(p, size);
+#else
+    (void)size;
+    ::operator delete(p);
+#endif
+}
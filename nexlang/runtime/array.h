@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "float_ops.h"
+
+// ================= ARRAY REP =================
+// Refcounted payload of an ARRAY Value. Elements are stored unboxed in one
+// of two typed, contiguous layouts:
+//   FLOAT  - every element is a number: a plain double[] that kernels and
+//            sorts can use directly
+//   STRING - anything else: all element bytes in one buffer plus an offset
+//            table (element i is chars[offsets[i], offsets[i + 1]))
+// A FLOAT array switches to STRING the first time a non-number is appended
+// (numbers are formatted, matching string-first semantics). Like strings,
+// arrays are immutable once they are wrapped in a Value.
+struct ArrayRep {
+    enum class Layout : uint8_t {
+        FLOAT,
+        STRING
+    };
+
+    mutable std::atomic<uint32_t> refCount{1};
+
+    ArrayRep() : offsets_{0} {}
+
+    Layout layout() const { return layout_; }
+
+    size_t size() const {
+        return layout_ == Layout::FLOAT ? numbers_.size() : offsets_.size() - 1;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_t count) {
+        if (layout_ == Layout::FLOAT) {
+            numbers_.reserve(count);
+        } else {
+            offsets_.reserve(count + 1);
+        }
+    }
+
+    void appendFloat(double value) {
+        if (layout_ == Layout::FLOAT) {
+            numbers_.push_back(value);
+        } else {
+            char buffer[kFloatBufferSize];
+            appendString(std::string_view(buffer, formatFloat(value, buffer, sizeof(buffer))));
+        }
+    }
+
+    void appendString(std::string_view text) {
+        if (layout_ == Layout::FLOAT) {
+            convertToStrings();
+        }
+        if (chars_.size() + text.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Array string storage exceeds 4 GiB");
+        }
+        chars_.append(text.data(), text.size());
+        offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+    }
+
+    // FLOAT layout only: contiguous elements
+    const double* floatData() const { return numbers_.data(); }
+    double floatAt(size_t index) const { return numbers_[index]; }
+
+    // STRING layout only
+    std::string_view stringAt(size_t index) const {
+        return std::string_view(chars_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+    // Mutable access for builders that fill a fresh array in place
+    std::vector<double>& floatStorage() { return numbers_; }
+
+    // "[1, 2, 3]"
+    std::string toString() const {
+        std::string text = "[";
+        char buffer[kFloatBufferSize];
+        for (size_t i = 0; i < size(); ++i) {
+            if (i > 0) text += ", ";
+            if (layout_ == Layout::FLOAT) {
+                text.append(buffer, formatFloat(numbers_[i], buffer, sizeof(buffer)));
+            } else {
+                text += stringAt(i);
+            }
+        }
+        text += "]";
+        return text;
+    }
+
+private:
+    Layout layout_ = Layout::FLOAT;
+    std::vector<double> numbers_;
+    std::vector<uint32_t> offsets_;   // size() + 1 entries, offsets_[0] == 0
+    std::string chars_;
+
+    void convertToStrings() {
+        std::vector<double> numbers;
+        numbers.swap(numbers_);
+        layout_ = Layout::STRING;
+        offsets_.reserve(numbers.size() + 1);
+        for (double value : numbers) {
+            appendFloat(value);
+        }
+    }
+};
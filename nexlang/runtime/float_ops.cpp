@@ -1,3 +1,207 @@
-// Placeholder for float operations implementation
+// Float operations implementation
+#include "float_ops.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 
-// Implement float operations here
+// ================= FLOAT FORMATTING =================
+
+// Integers below 2^53 are exact doubles; print them with plain digit loops
+static constexpr double kExactIntegerLimit = 9007199254740992.0;
+
+static size_t formatInteger(int64_t value, char* buffer, size_t capacity) {
+    char digits[20];
+    size_t count = 0;
+    uint64_t magnitude = value < 0 ? static_cast<uint64_t>(-value) : static_cast<uint64_t>(value);
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    size_t length = count + (value < 0 ? 1 : 0);
+    if (length > capacity) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    if (value < 0) {
+        buffer[pos++] = '-';
+    }
+    while (count > 0) {
+        buffer[pos++] = digits[--count];
+    }
+    return length;
+}
+
+size_t formatFloat(double value, char* buffer, size_t capacity) {
+    if (std::abs(value) < kExactIntegerLimit && value == std::trunc(value) &&
+        !(value == 0.0 && std::signbit(value))) {
+        return formatInteger(static_cast<int64_t>(value), buffer, capacity);
+    }
+
+    // Shortest round-trip representation (Ryu-based in the standard library)
+    auto result = std::to_chars(buffer, buffer + capacity, value);
+    if (result.ec != std::errc()) {
+        return 0;
+    }
+    return static_cast<size_t>(result.ptr - buffer);
+}
+
+std::string floatToString(double value) {
+    char buffer[kFloatBufferSize];
+    return std::string(buffer, formatFloat(value, buffer, sizeof(buffer)));
+}
+
+// ================= FLOAT PARSING =================
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// SWAR: true if all 8 bytes are ASCII digits
+static bool allEightDigits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+// SWAR: value of 8 ASCII digits (first char most significant, little-endian load)
+static uint32_t parseEightDigits(uint64_t chunk) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL;  // 100 + (1000000ULL << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL;  // 1 + (10000ULL << 32)
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(chunk);
+}
+
+static bool littleEndian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// Consume a run of digits into mantissa (saturating after 19 significant
+// digits); returns the number of digits consumed
+static size_t scanDigits(const char*& p, const char* end, uint64_t& mantissa, size_t& significant) {
+    const char* start = p;
+    static const bool kLittleEndian = littleEndian();
+    while (kLittleEndian && end - p >= 8 && significant + 8 <= 19) {
+        uint64_t chunk;
+        std::memcpy(&chunk, p, 8);
+        if (!allEightDigits(chunk)) {
+            break;
+        }
+        mantissa = mantissa * 100000000ULL + parseEightDigits(chunk);
+        if (mantissa != 0 || significant != 0) {
+            significant += 8;
+        }
+        p += 8;
+    }
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            if (mantissa != 0) {
+                ++significant;
+            }
+        } else {
+            ++significant;   // digits past 19 only mark the result inexact
+        }
+        ++p;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+// Long mantissas, big exponents, subnormals: std::from_chars, which is
+// Eisel-Lemire with an exact fallback in current standard libraries.
+// Results that overflow to infinity or underflow to zero are out of range.
+static std::optional<double> parseFallback(const char* begin, const char* end, bool negative) {
+    if (begin == end || *begin == '-' || *begin == '+') {
+        return std::nullopt;
+    }
+    double value = 0.0;
+    auto result = std::from_chars(begin, end, value);
+    if (result.ec != std::errc() || result.ptr != end) {
+        return std::nullopt;
+    }
+    return negative ? -value : value;
+}
+
+std::optional<double> parseFloat(std::string_view text) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    while (begin < end && isSpace(*begin)) ++begin;
+    while (end > begin && isSpace(end[-1])) --end;
+
+    bool negative = false;
+    if (begin < end && (*begin == '+' || *begin == '-')) {
+        negative = *begin == '-';
+        ++begin;
+    }
+    if (begin == end) {
+        return std::nullopt;
+    }
+
+    // Fast path: [digits][.digits][e[+-]digits] with an exactly representable
+    // mantissa and power of ten (Clinger). Everything else falls back below.
+    const char* p = begin;
+    uint64_t mantissa = 0;
+    size_t significant = 0;
+    size_t intDigits = scanDigits(p, end, mantissa, significant);
+    size_t fracDigits = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        fracDigits = scanDigits(p, end, mantissa, significant);
+    }
+    if (intDigits + fracDigits == 0) {
+        return std::nullopt;   // no digits: "inf", "nan" and other words are not numbers
+    }
+
+    int64_t exponent = 0;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '+' || *p == '-')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p == end || *p < '0' || *p > '9') {
+            return std::nullopt;
+        }
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (exponent < 100000) {
+                exponent = exponent * 10 + (*p - '0');
+            }
+            ++p;
+        }
+        if (negativeExponent) {
+            exponent = -exponent;
+        }
+    }
+    if (p != end) {
+        return std::nullopt;
+    }
+
+    // Every digit made it into the mantissa, so the value is exactly
+    // mantissa * 10^power; exact in double when both factors are. One
+    // division or multiplication then rounds correctly. A non-zero result is
+    // at least 1e-22, so it is always a normal number; subnormals only come
+    // from exponents the fallback handles.
+    if (significant <= 19 && mantissa <= (1ULL << 53)) {
+        static const double kPowersOfTen[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        int64_t power = exponent - static_cast<int64_t>(fracDigits);
+        if (power >= -22 && power <= 22) {
+            double value = static_cast<double>(mantissa);
+            value = power < 0 ? value / kPowersOfTen[-power] : value * kPowersOfTen[power];
+            return negative ? -value : value;
+        }
+    }
+
+    return parseFallback(begin, end, negative);
+}
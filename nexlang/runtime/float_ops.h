@@ -1,4 +1,28 @@
 // Header for float operations
 #pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
 
-// Declare float operation functions here
+// ================= FLOAT FORMATTING =================
+
+// Enough room for any double formatFloat produces ("-1.7976931348623157e+308")
+constexpr size_t kFloatBufferSize = 32;
+
+// Write the shortest text that parses back to exactly `value` into buffer.
+// Integral values print without a fraction ("10", not "10.000000").
+// No allocation, no locale, no NUL terminator. Returns the number of chars
+// written, or 0 if capacity is too small.
+size_t formatFloat(double value, char* buffer, size_t capacity);
+
+// Allocating convenience wrapper around formatFloat
+std::string floatToString(double value);
+
+// ================= FLOAT PARSING =================
+
+// Parse text as a number, correctly rounded. The whole text must be a
+// finite number (surrounding whitespace and a leading '+' are allowed);
+// otherwise, and for "inf", "nan" or values beyond the double range,
+// returns nullopt. Never throws and never allocates.
+std::optional<double> parseFloat(std::string_view text);
@@ -0,0 +1,244 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ================= HANDLE KINDS =================
+enum class HandleKind : uint8_t {
+    FILE,
+    BLOCK,
+    SOCKET,
+    TIMER
+};
+
+constexpr size_t kHandleKindCount = 4;
+
+inline const char* handleKindName(HandleKind kind) {
+    switch (kind) {
+        case HandleKind::FILE:   return "file";
+        case HandleKind::BLOCK:  return "block";
+        case HandleKind::SOCKET: return "socket";
+        case HandleKind::TIMER:  return "timer";
+    }
+    return "unknown";
+}
+
+// ================= HANDLE =================
+// Plain 12-byte reference to a slot in the HandleTable: the slot index and
+// the slot's generation. The generation changes every time a slot is reused,
+// so a handle that outlived its resource no longer resolves; with 32 bits it
+// takes 2^32 - 1 reuses of one slot before an id repeats. Generation 0 is
+// never issued, so id 0 means "no handle".
+struct Handle {
+    static constexpr uint32_t kIndexBits = 20;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+
+    uint32_t slot = 0;
+    uint32_t gen = 0;
+    HandleKind kind = HandleKind::FILE;
+
+    Handle() = default;
+    Handle(HandleKind k, uint32_t index, uint32_t generation) : slot(index), gen(generation), kind(k) {}
+
+    uint32_t index() const { return slot; }
+    uint32_t generation() const { return gen; }
+    bool valid() const { return gen != 0; }
+
+    // Generation and index in one number (52 bits, so exact as a double)
+    uint64_t id() const { return (static_cast<uint64_t>(gen) << kIndexBits) | slot; }
+
+    // Generation a slot gets when it is reused; wraps past 0
+    static uint32_t nextGeneration(uint32_t generation) {
+        return generation == UINT32_MAX ? 1 : generation + 1;
+    }
+
+    bool operator==(const Handle& other) const {
+        return slot == other.slot && gen == other.gen && kind == other.kind;
+    }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+// Closes a resource when its handle is released (may be null)
+using HandleReleaseFn = void (*)(void*);
+
+// ================= HANDLE TABLE =================
+// Owns every live runtime resource. Each kind has its own slab of slots and
+// free list, so resolving a handle is one index plus a generation compare.
+class HandleTable {
+public:
+    static HandleTable& getInstance() {
+        static HandleTable instance;
+        return instance;
+    }
+
+    HandleTable(const HandleTable&) = delete;
+    HandleTable& operator=(const HandleTable&) = delete;
+
+    // Register a resource. The handle is owned by the innermost active
+    // HandleScope on this thread (if any) and released when it exits.
+    Handle open(HandleKind kind, void* resource, HandleReleaseFn release = nullptr);
+
+    // Resource behind a live handle, nullptr if the handle is stale
+    void* resolve(Handle handle) {
+        Slab& slab = slabFor(handle.kind);
+        std::lock_guard<std::mutex> lock(slab.mutex);
+        const Slot* slot = slab.find(handle);
+        return slot ? slot->resource : nullptr;
+    }
+
+    bool isLive(Handle handle) {
+        Slab& slab = slabFor(handle.kind);
+        std::lock_guard<std::mutex> lock(slab.mutex);
+        return slab.find(handle) != nullptr;
+    }
+
+    // Release one handle now; false if it was already stale
+    bool close(Handle handle) {
+        return release(&handle, 1) == 1;
+    }
+
+    // Release a batch of handles, taking each slab's lock once. Release
+    // callbacks run after the locks are dropped. Returns how many were live.
+    size_t release(const Handle* handles, size_t count) {
+        std::vector<std::pair<HandleReleaseFn, void*>> closers;
+        size_t released = 0;
+        for (size_t k = 0; k < kHandleKindCount; ++k) {
+            Slab& slab = slabs_[k];
+            std::unique_lock<std::mutex> lock(slab.mutex, std::defer_lock);
+            for (size_t i = 0; i < count; ++i) {
+                if (static_cast<size_t>(handles[i].kind) != k) {
+                    continue;
+                }
+                if (!lock.owns_lock()) {
+                    lock.lock();
+                }
+                Slot* slot = slab.find(handles[i]);
+                if (!slot) {
+                    continue;
+                }
+                if (slot->release) {
+                    closers.emplace_back(slot->release, slot->resource);
+                }
+                slab.free(handles[i].index());
+                ++released;
+            }
+        }
+        for (auto& closer : closers) {
+            closer.first(closer.second);
+        }
+        return released;
+    }
+
+    // Live handles of one kind
+    size_t liveCount(HandleKind kind) {
+        Slab& slab = slabFor(kind);
+        std::lock_guard<std::mutex> lock(slab.mutex);
+        return slab.slots.size() - slab.freeList.size();
+    }
+
+private:
+    struct Slot {
+        void* resource = nullptr;
+        HandleReleaseFn release = nullptr;
+        uint32_t generation = 1;
+        bool live = false;
+    };
+
+    struct Slab {
+        std::mutex mutex;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeList;
+
+        Slot* find(Handle handle) {
+            uint32_t index = handle.index();
+            if (index >= slots.size()) {
+                return nullptr;
+            }
+            Slot& slot = slots[index];
+            return slot.live && slot.generation == handle.generation() ? &slot : nullptr;
+        }
+
+        void free(uint32_t index) {
+            Slot& slot = slots[index];
+            slot.live = false;
+            slot.resource = nullptr;
+            slot.release = nullptr;
+            slot.generation = Handle::nextGeneration(slot.generation);
+            freeList.push_back(index);
+        }
+    };
+
+    Slab slabs_[kHandleKindCount];
+
+    HandleTable() = default;
+
+    Slab& slabFor(HandleKind kind) {
+        return slabs_[static_cast<size_t>(kind)];
+    }
+};
+
+// ================= HANDLE SCOPE =================
+// Collects the handles opened on this thread while it is alive and releases
+// them together when it goes out of scope. The engine opens one per block, so
+// a block's files, sockets and timers are closed in one batch at block exit.
+class HandleScope {
+public:
+    HandleScope() : parent_(current()) {
+        current() = this;
+    }
+
+    ~HandleScope() {
+        current() = parent_;
+        HandleTable::getInstance().release(owned_.data(), owned_.size());
+    }
+
+    HandleScope(const HandleScope&) = delete;
+    HandleScope& operator=(const HandleScope&) = delete;
+
+    void adopt(Handle handle) {
+        owned_.push_back(handle);
+    }
+
+    // Innermost scope on the calling thread, or nullptr
+    static HandleScope*& current() {
+        thread_local HandleScope* scope = nullptr;
+        return scope;
+    }
+
+private:
+    HandleScope* parent_;
+    std::vector<Handle> owned_;
+};
+
+inline Handle HandleTable::open(HandleKind kind, void* resource, HandleReleaseFn release) {
+    Slab& slab = slabFor(kind);
+    uint32_t index;
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(slab.mutex);
+        if (!slab.freeList.empty()) {
+            index = slab.freeList.back();
+            slab.freeList.pop_back();
+        } else {
+            if (slab.slots.size() > Handle::kIndexMask) {
+                throw std::runtime_error(std::string("Too many open ") + handleKindName(kind) + " handles");
+            }
+            index = static_cast<uint32_t>(slab.slots.size());
+            slab.slots.emplace_back();
+        }
+        Slot& slot = slab.slots[index];
+        slot.resource = resource;
+        slot.release = release;
+        slot.live = true;
+        generation = slot.generation;
+    }
+
+    Handle handle(kind, index, generation);
+    if (HandleScope* scope = HandleScope::current()) {
+        scope->adopt(handle);
+    }
+    return handle;
+}
@@ -0,0 +1,94 @@
+// Header for the ops and types named by builtin intrinsics
+#pragma once
+#include <cstdint>
+#include "value.h"
+
+// Builtins describe their lowering (see Intrinsic in builtins_registry.h)
+// in these terms; the compiler's IR uses the same enums.
+
+// ================= IR OPCODES =================
+// Scalar and vector ops have exactly the semantics of the builtins they
+// are lowered from, restricted to operands of the stated type. Vector ops
+// work on FLOAT_ARRAY operands and, like the batch builtins, require equal
+// lengths.
+enum class IrOp : uint8_t {
+    CONST,          // constants[constant]
+    CALL_BUILTIN,   // call through the registry's dispatch table
+
+    // FLOAT x FLOAT -> FLOAT
+    FADD,
+    FSUB,
+    FMUL,
+
+    // STRING x STRING -> STRING
+    CONCAT,
+
+    // FLOAT arrays -> FLOAT array
+    VADD,
+    VMUL,
+    VFMA,           // a * b + c
+    VCMP_LT,        // 1.0 / 0.0 per element
+    VCMP_EQ,
+    VCMP_GT,
+
+    // FLOAT arrays -> FLOAT
+    VDOT,
+    VSUM,
+    VMIN,
+    VMAX
+};
+
+inline const char* irOpName(IrOp op) {
+    switch (op) {
+        case IrOp::CONST:        return "const";
+        case IrOp::CALL_BUILTIN: return "call";
+        case IrOp::FADD:         return "fadd";
+        case IrOp::FSUB:         return "fsub";
+        case IrOp::FMUL:         return "fmul";
+        case IrOp::CONCAT:       return "concat";
+        case IrOp::VADD:         return "vadd";
+        case IrOp::VMUL:         return "vmul";
+        case IrOp::VFMA:         return "vfma";
+        case IrOp::VCMP_LT:      return "vcmp.lt";
+        case IrOp::VCMP_EQ:      return "vcmp.eq";
+        case IrOp::VCMP_GT:      return "vcmp.gt";
+        case IrOp::VDOT:         return "vdot";
+        case IrOp::VSUM:         return "vsum";
+        case IrOp::VMIN:         return "vmin";
+        case IrOp::VMAX:         return "vmax";
+    }
+    return "?";
+}
+
+// ================= IR TYPES =================
+// Static type of an IR value; UNKNOWN when it is only known at run time
+enum class IrType : uint8_t {
+    UNKNOWN,
+    STRING,
+    FLOAT,
+    BOOL,
+    HANDLE,
+    ARRAY,          // either layout
+    FLOAT_ARRAY,    // ARRAY known to be in the FLOAT layout
+    TABLE
+};
+
+inline IrType irTypeOf(ValueType type) {
+    switch (type) {
+        case ValueType::STRING: return IrType::STRING;
+        case ValueType::FLOAT:  return IrType::FLOAT;
+        case ValueType::BOOL:   return IrType::BOOL;
+        case ValueType::HANDLE: return IrType::HANDLE;
+        case ValueType::ARRAY:  return IrType::ARRAY;
+        case ValueType::TABLE:  return IrType::TABLE;
+    }
+    return IrType::UNKNOWN;
+}
+
+// Type of a known value: arrays also carry their layout
+inline IrType irTypeOf(const Value& value) {
+    if (value.getType() == ValueType::ARRAY && value.getArray().layout() == ArrayRep::Layout::FLOAT) {
+        return IrType::FLOAT_ARRAY;
+    }
+    return irTypeOf(value.getType());
+}
@@ -0,0 +1,730 @@
+// Regex engine implementation
+#include "regex.h"
+#include "string_ops.h"
+#include <algorithm>
+#include <stdexcept>
+
+// ================= COMPILER =================
+// Parses the pattern into a small syntax tree, then emits the NFA program.
+// Counted repeats are expanded, so the program size is bounded.
+class RegexCompiler {
+public:
+    static constexpr int kMaxRepeat = 1000;
+    static constexpr size_t kMaxProgram = 100000;
+
+    RegexCompiler(Regex& re) : re_(re), text_(re.pattern_) {}
+
+    void compile() {
+        size_t root = parseAlternation();
+        if (pos_ < text_.size()) {
+            fail(text_[pos_] == ')' ? "unmatched ')'" : "unexpected character");
+        }
+        emit(root);
+        push(Regex::Op::MATCH);
+
+        literalPrefix(root, re_.prefix_);
+        re_.computeByteClasses();
+        re_.marks_.assign(re_.program_.size(), 0);
+    }
+
+private:
+    enum class Kind : uint8_t {
+        EMPTY,
+        BYTES,
+        CONCAT,
+        ALTERNATE,
+        REPEAT,   // min..max copies (max -1: unbounded)
+        BOL,
+        EOL
+    };
+
+    struct Node {
+        Kind kind;
+        uint32_t set = 0;
+        int min = 0;
+        int max = 0;
+        std::vector<size_t> kids;
+    };
+
+    Regex& re_;
+    std::string_view text_;
+    size_t pos_ = 0;
+    std::vector<Node> nodes_;
+    std::unordered_map<std::bitset<256>, uint32_t> setIds_;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("Invalid regex '" + std::string(text_) + "': " + message);
+    }
+
+    bool atEnd() const { return pos_ >= text_.size(); }
+    char peek() const { return text_[pos_]; }
+
+    size_t node(Kind kind) {
+        nodes_.emplace_back();
+        nodes_.back().kind = kind;
+        return nodes_.size() - 1;
+    }
+
+    size_t bytesNode(const std::bitset<256>& set) {
+        auto it = setIds_.find(set);
+        uint32_t id;
+        if (it != setIds_.end()) {
+            id = it->second;
+        } else {
+            id = static_cast<uint32_t>(re_.sets_.size());
+            re_.sets_.push_back(set);
+            setIds_.emplace(set, id);
+        }
+        size_t n = node(Kind::BYTES);
+        nodes_[n].set = id;
+        return n;
+    }
+
+    // ================= PARSER =================
+
+    size_t parseAlternation() {
+        size_t first = parseConcat();
+        if (atEnd() || peek() != '|') {
+            return first;
+        }
+        size_t alt = node(Kind::ALTERNATE);
+        nodes_[alt].kids.push_back(first);
+        while (!atEnd() && peek() == '|') {
+            ++pos_;
+            size_t next = parseConcat();
+            nodes_[alt].kids.push_back(next);
+        }
+        return alt;
+    }
+
+    size_t parseConcat() {
+        size_t concat = node(Kind::CONCAT);
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            size_t item = parseRepeat();
+            nodes_[concat].kids.push_back(item);
+        }
+        return concat;
+    }
+
+    size_t parseRepeat() {
+        size_t atom = parseAtom();
+        while (!atEnd()) {
+            int min, max;
+            char c = peek();
+            if (c == '*') {
+                min = 0; max = -1; ++pos_;
+            } else if (c == '+') {
+                min = 1; max = -1; ++pos_;
+            } else if (c == '?') {
+                min = 0; max = 1; ++pos_;
+            } else if (c == '{' && parseCount(min, max)) {
+                // pos_ is past the '}'
+            } else {
+                break;
+            }
+            if (!atEnd() && peek() == '?') {
+                fail("lazy quantifiers are not supported (matches are leftmost-longest)");
+            }
+            size_t repeat = node(Kind::REPEAT);
+            nodes_[repeat].min = min;
+            nodes_[repeat].max = max;
+            nodes_[repeat].kids.push_back(atom);
+            atom = repeat;
+        }
+        return atom;
+    }
+
+    // {m} {m,} {m,n}; anything else leaves '{' to be read as a literal
+    bool parseCount(int& min, int& max) {
+        size_t p = pos_ + 1;
+        auto number = [&](int& out) {
+            size_t begin = p;
+            long value = 0;
+            while (p < text_.size() && text_[p] >= '0' && text_[p] <= '9') {
+                value = value * 10 + (text_[p] - '0');
+                if (value > kMaxRepeat) fail("repeat count over " + std::to_string(kMaxRepeat));
+                ++p;
+            }
+            out = static_cast<int>(value);
+            return p > begin;
+        };
+        if (!number(min)) return false;
+        max = min;
+        if (p < text_.size() && text_[p] == ',') {
+            ++p;
+            if (!number(max)) max = -1;
+        }
+        if (p >= text_.size() || text_[p] != '}') return false;
+        if (max != -1 && max < min) fail("bad repeat range");
+        pos_ = p + 1;
+        return true;
+    }
+
+    size_t parseAtom() {
+        char c = peek();
+        switch (c) {
+            case '(': {
+                ++pos_;
+                if (text_.substr(pos_, 2) == "?:") {
+                    pos_ += 2;
+                } else if (!atEnd() && peek() == '?') {
+                    fail("unsupported group syntax");
+                }
+                size_t inner = parseAlternation();
+                if (atEnd() || peek() != ')') fail("missing ')'");
+                ++pos_;
+                return inner;
+            }
+            case '[':
+                ++pos_;
+                return bytesNode(parseClass());
+            case '.': {
+                ++pos_;
+                std::bitset<256> set;
+                set.set();
+                set.reset('\n');
+                return bytesNode(set);
+            }
+            case '^':
+                ++pos_;
+                return node(Kind::BOL);
+            case '$':
+                ++pos_;
+                return node(Kind::EOL);
+            case '*':
+            case '+':
+            case '?':
+                fail("nothing to repeat");
+            case '\\': {
+                ++pos_;
+                std::bitset<256> set;
+                parseEscape(set);
+                return bytesNode(set);
+            }
+            default: {
+                ++pos_;
+                std::bitset<256> set;
+                set.set(static_cast<uint8_t>(c));
+                return bytesNode(set);
+            }
+        }
+    }
+
+    // After a backslash: adds the escaped byte or class to set
+    void parseEscape(std::bitset<256>& set) {
+        if (atEnd()) fail("trailing backslash");
+        char c = text_[pos_++];
+        switch (c) {
+            case 'd': case 'D': case 'w': case 'W': case 's': case 'S': {
+                std::bitset<256> cls;
+                for (int b = 0; b < 256; ++b) {
+                    bool in = (c == 'd' || c == 'D') ? (b >= '0' && b <= '9')
+                            : (c == 's' || c == 'S') ? (b == ' ' || (b >= '\t' && b <= '\r'))
+                            : ((b >= '0' && b <= '9') || (b >= 'a' && b <= 'z') ||
+                               (b >= 'A' && b <= 'Z') || b == '_');
+                    cls.set(b, in);
+                }
+                if (c == 'D' || c == 'S' || c == 'W') cls.flip();
+                set |= cls;
+                return;
+            }
+            case 't': set.set('\t'); return;
+            case 'n': set.set('\n'); return;
+            case 'r': set.set('\r'); return;
+            case 'f': set.set('\f'); return;
+            case 'v': set.set('\v'); return;
+            case '0': set.set(0); return;
+            default:
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+                    fail(std::string("unknown escape \\") + c);
+                }
+                set.set(static_cast<uint8_t>(c));
+                return;
+        }
+    }
+
+    // After '[': items up to the closing ']'
+    std::bitset<256> parseClass() {
+        std::bitset<256> set;
+        bool negate = !atEnd() && peek() == '^';
+        if (negate) ++pos_;
+        bool first = true;
+        while (true) {
+            if (atEnd()) fail("missing ']'");
+            char c = peek();
+            if (c == ']' && !first) {
+                ++pos_;
+                break;
+            }
+            first = false;
+            ++pos_;
+            if (c == '\\') {
+                std::bitset<256> escaped;
+                parseEscape(escaped);
+                if (escaped.count() != 1 || atEnd() || peek() != '-') {
+                    set |= escaped;
+                    continue;
+                }
+                c = static_cast<char>(firstByte(escaped));
+            }
+            // Range a-z (a '-' before ']' is literal)
+            if (pos_ + 1 < text_.size() && peek() == '-' && text_[pos_ + 1] != ']') {
+                ++pos_;
+                uint8_t low = static_cast<uint8_t>(c);
+                uint8_t high = static_cast<uint8_t>(text_[pos_++]);
+                if (high == '\\') {
+                    std::bitset<256> escaped;
+                    parseEscape(escaped);
+                    if (escaped.count() != 1) fail("bad class range");
+                    high = firstByte(escaped);
+                }
+                if (high < low) fail("bad class range");
+                for (int b = low; b <= high; ++b) set.set(b);
+            } else {
+                set.set(static_cast<uint8_t>(c));
+            }
+        }
+        if (negate) set.flip();
+        return set;
+    }
+
+    static uint8_t firstByte(const std::bitset<256>& set) {
+        for (int b = 0; b < 256; ++b) {
+            if (set.test(b)) return static_cast<uint8_t>(b);
+        }
+        return 0;
+    }
+
+    // ================= CODE GENERATION =================
+
+    size_t push(Regex::Op op, uint32_t arg = 0, uint32_t arg2 = 0) {
+        if (re_.program_.size() >= kMaxProgram) fail("pattern too large");
+        re_.program_.push_back(Regex::Inst{op, arg, arg2});
+        return re_.program_.size() - 1;
+    }
+
+    uint32_t here() const {
+        return static_cast<uint32_t>(re_.program_.size());
+    }
+
+    void emit(size_t n) {
+        const Node& nd = nodes_[n];
+        switch (nd.kind) {
+            case Kind::EMPTY:
+                break;
+            case Kind::BYTES:
+                push(Regex::Op::BYTES, nd.set);
+                break;
+            case Kind::BOL:
+                push(Regex::Op::BOL);
+                break;
+            case Kind::EOL:
+                push(Regex::Op::EOL);
+                break;
+            case Kind::CONCAT:
+                for (size_t kid : nd.kids) emit(kid);
+                break;
+            case Kind::ALTERNATE: {
+                //   split L1, L2;  L1: a; jump end;  L2: split ... ; last; end:
+                std::vector<size_t> jumps;
+                for (size_t i = 0; i + 1 < nd.kids.size(); ++i) {
+                    size_t split = push(Regex::Op::SPLIT, here() + 1);
+                    emit(nd.kids[i]);
+                    jumps.push_back(push(Regex::Op::JUMP));
+                    re_.program_[split].arg2 = here();
+                }
+                emit(nd.kids.back());
+                for (size_t jump : jumps) re_.program_[jump].arg = here();
+                break;
+            }
+            case Kind::REPEAT: {
+                int min = nd.min;
+                int max = nd.max;
+                size_t kid = nd.kids[0];
+                for (int i = 0; i < min; ++i) emit(kid);
+                if (max == -1) {
+                    //   L0: split L1, end;  L1: a; jump L0;  end:
+                    size_t split = push(Regex::Op::SPLIT, here() + 1);
+                    emit(kid);
+                    push(Regex::Op::JUMP, static_cast<uint32_t>(split));
+                    re_.program_[split].arg2 = here();
+                } else {
+                    // a{0,k}: k optional copies, each skipping to the end
+                    std::vector<size_t> splits;
+                    for (int i = min; i < max; ++i) {
+                        splits.push_back(push(Regex::Op::SPLIT, here() + 1));
+                        emit(kid);
+                    }
+                    for (size_t split : splits) re_.program_[split].arg2 = here();
+                }
+                break;
+            }
+        }
+    }
+
+    // Appends the literal bytes every match of node n starts with; returns
+    // true if the whole node was literal (so what follows extends it)
+    bool literalPrefix(size_t n, std::string& out) {
+        const Node& nd = nodes_[n];
+        switch (nd.kind) {
+            case Kind::EMPTY:
+                return true;
+            case Kind::BYTES: {
+                const std::bitset<256>& set = re_.sets_[nd.set];
+                if (set.count() != 1) return false;
+                out.push_back(static_cast<char>(firstByte(set)));
+                return true;
+            }
+            case Kind::BOL:
+                // Leading ^: matches can only start at text start
+                if (out.empty()) {
+                    re_.anchoredStart_ = true;
+                    return true;
+                }
+                return false;
+            case Kind::CONCAT:
+                for (size_t kid : nd.kids) {
+                    if (!literalPrefix(kid, out)) return false;
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+};
+
+// ================= REGEX =================
+
+Regex::Regex(std::string_view pattern) : pattern_(pattern) {
+    anchored_.unanchored = false;
+    unanchored_.unanchored = true;
+    RegexCompiler(*this).compile();
+}
+
+void Regex::computeByteClasses() {
+    std::unordered_map<std::string, uint8_t> classes;
+    std::string signature(sets_.size(), '0');
+    for (int b = 0; b < 256; ++b) {
+        for (size_t i = 0; i < sets_.size(); ++i) {
+            signature[i] = sets_[i].test(b) ? '1' : '0';
+        }
+        auto it = classes.emplace(signature, static_cast<uint8_t>(classes.size())).first;
+        byteClass_[b] = it->second;
+    }
+    classCount_ = classes.size();
+}
+
+uint32_t Regex::nextGeneration() {
+    if (++generation_ == 0) {
+        std::fill(marks_.begin(), marks_.end(), 0);
+        generation_ = 1;
+    }
+    return generation_;
+}
+
+bool Regex::matches(std::string_view text) {
+    int32_t row = startState(anchored_, true);
+    for (char c : text) {
+        uint8_t byte = static_cast<uint8_t>(c);
+        int32_t next = anchored_.transitions[row + byteClass_[byte]];
+        if (next == kUnknown) {
+            next = step(anchored_, row, byte);
+        }
+        if (next == kDead) {
+            return false;
+        }
+        row = next & kRowMask;
+    }
+    return anchored_.states[row / classCount_].matchAtEnd;
+}
+
+bool Regex::search(std::string_view text, size_t from, RegexMatch& match) {
+    if (from > text.size() || (anchoredStart_ && from > 0)) {
+        return false;
+    }
+    // Every match starts with the prefix, so the leftmost one cannot start
+    // before its first occurrence
+    size_t begin = from;
+    if (!prefix_.empty()) {
+        begin = findString(text, prefix_, from);
+        if (begin == kNotFound) {
+            return false;
+        }
+    }
+    size_t end;
+    if (!firstMatchEnd(text, begin, end)) {
+        return false;
+    }
+    return pike(text, begin, match);
+}
+
+// ================= LAZY DFA =================
+
+void Regex::closure(uint32_t pc, bool atStart, uint32_t generation, std::vector<uint32_t>& out) {
+    stack_.clear();
+    stack_.push_back(pc);
+    while (!stack_.empty()) {
+        uint32_t at = stack_.back();
+        stack_.pop_back();
+        if (marks_[at] == generation) {
+            continue;
+        }
+        marks_[at] = generation;
+        const Inst& inst = program_[at];
+        switch (inst.op) {
+            case Op::BYTES:
+            case Op::EOL:
+            case Op::MATCH:
+                out.push_back(at);
+                break;
+            case Op::SPLIT:
+                stack_.push_back(inst.arg2);
+                stack_.push_back(inst.arg);
+                break;
+            case Op::JUMP:
+                stack_.push_back(inst.arg);
+                break;
+            case Op::BOL:
+                if (atStart) stack_.push_back(at + 1);
+                break;
+        }
+    }
+}
+
+// From an EOL at the end of text: is MATCH reachable without consuming?
+bool Regex::reachesMatchAtEnd(uint32_t pc, bool atStart) const {
+    std::vector<uint32_t> pending{pc + 1};
+    std::vector<bool> seen(program_.size());
+    while (!pending.empty()) {
+        uint32_t at = pending.back();
+        pending.pop_back();
+        if (seen[at]) continue;
+        seen[at] = true;
+        const Inst& inst = program_[at];
+        switch (inst.op) {
+            case Op::MATCH: return true;
+            case Op::BYTES: break;
+            case Op::SPLIT: pending.push_back(inst.arg); pending.push_back(inst.arg2); break;
+            case Op::JUMP: pending.push_back(inst.arg); break;
+            case Op::EOL: pending.push_back(at + 1); break;
+            case Op::BOL: if (atStart) pending.push_back(at + 1); break;
+        }
+    }
+    return false;
+}
+
+int32_t Regex::addState(Dfa& dfa, std::vector<uint32_t>& insts, bool atStart) {
+    std::sort(insts.begin(), insts.end());
+    std::string key(reinterpret_cast<const char*>(insts.data()), insts.size() * sizeof(uint32_t));
+    key.push_back(atStart ? '\1' : '\0');
+    auto it = dfa.index.find(key);
+    if (it != dfa.index.end()) {
+        return it->second;
+    }
+
+    // Bounded memory: start over rather than grow without limit
+    if (dfa.states.size() >= kMaxDfaStates) {
+        dfa.states.clear();
+        dfa.transitions.clear();
+        dfa.index.clear();
+        dfa.start[0] = dfa.start[1] = -1;
+    }
+
+    DfaState state;
+    state.insts = insts;
+    state.atStart = atStart;
+    state.match = false;
+    state.matchAtEnd = false;
+    for (uint32_t pc : insts) {
+        if (program_[pc].op == Op::MATCH) {
+            state.match = state.matchAtEnd = true;
+        } else if (program_[pc].op == Op::EOL && !state.matchAtEnd) {
+            state.matchAtEnd = reachesMatchAtEnd(pc, atStart);
+        }
+    }
+    int32_t id = static_cast<int32_t>(dfa.states.size());
+    dfa.states.push_back(std::move(state));
+    dfa.transitions.resize(dfa.transitions.size() + classCount_, kUnknown);
+    dfa.index.emplace(std::move(key), id);
+    return id;
+}
+
+int32_t Regex::startState(Dfa& dfa, bool atStart) {
+    int32_t start = dfa.start[atStart ? 1 : 0];
+    if (start < 0) {
+        insts_.clear();
+        closure(0, atStart, nextGeneration(), insts_);
+        start = addState(dfa, insts_, atStart) * static_cast<int32_t>(classCount_);
+        dfa.start[atStart ? 1 : 0] = start;
+    }
+    return start;
+}
+
+int32_t Regex::step(Dfa& dfa, int32_t row, uint8_t byte) {
+    size_t slot = static_cast<size_t>(row) + byteClass_[byte];
+    if (dfa.transitions[slot] != kUnknown) {
+        return dfa.transitions[slot];
+    }
+
+    insts_.clear();
+    uint32_t generation = nextGeneration();
+    for (uint32_t pc : dfa.states[row / classCount_].insts) {
+        const Inst& inst = program_[pc];
+        if (inst.op == Op::BYTES && sets_[inst.arg].test(byte)) {
+            closure(pc + 1, false, generation, insts_);
+        }
+    }
+    if (dfa.unanchored) {
+        closure(0, false, generation, insts_);
+    }
+    if (insts_.empty()) {
+        dfa.transitions[slot] = kDead;
+        return kDead;
+    }
+
+    size_t before = dfa.states.size();
+    int32_t target = addState(dfa, insts_, false);
+    int32_t next = target * static_cast<int32_t>(classCount_) | (dfa.states[target].match ? kMatchFlag : 0);
+    // A flush drops the source state; only link it if it survived
+    if (dfa.states.size() >= before) {
+        dfa.transitions[slot] = next;
+    }
+    return next;
+}
+
+bool Regex::firstMatchEnd(std::string_view text, size_t from, size_t& end) {
+    int32_t row = startState(unanchored_, from == 0);
+    if (unanchored_.states[row / classCount_].match) {
+        end = from;
+        return true;
+    }
+    for (size_t i = from; i < text.size(); ++i) {
+        uint8_t byte = static_cast<uint8_t>(text[i]);
+        int32_t next = unanchored_.transitions[row + byteClass_[byte]];
+        if (next == kUnknown) {
+            next = step(unanchored_, row, byte);
+        }
+        if (next == kDead) {
+            return false;   // only when the pattern cannot restart (it needs ^)
+        }
+        if (next & kMatchFlag) {
+            end = i + 1;
+            return true;
+        }
+        row = next;
+    }
+    if (unanchored_.states[row / classCount_].matchAtEnd) {
+        end = text.size();
+        return true;
+    }
+    return false;
+}
+
+// ================= NFA SIMULATION =================
+// Pike VM. Threads are kept in order of their start position (new threads
+// start after all existing ones), and a thread reaching an instruction
+// another thread already holds at that position is dropped: the earlier
+// start wins. Once a match is found no new threads start and later-starting
+// threads are abandoned; the rest run on to find the longest match. Until
+// then an empty thread list does not end the scan: a thread that starts
+// with an assertion ($) may only survive at a later position.
+
+void Regex::addThread(std::vector<Thread>& list, uint32_t pc, size_t start, size_t pos,
+                      size_t size, uint32_t generation) {
+    stack_.clear();
+    stack_.push_back(pc);
+    while (!stack_.empty()) {
+        uint32_t at = stack_.back();
+        stack_.pop_back();
+        if (marks_[at] == generation) {
+            continue;
+        }
+        marks_[at] = generation;
+        const Inst& inst = program_[at];
+        switch (inst.op) {
+            case Op::BYTES:
+            case Op::MATCH:
+                list.push_back(Thread{at, start});
+                break;
+            case Op::SPLIT:
+                stack_.push_back(inst.arg2);
+                stack_.push_back(inst.arg);
+                break;
+            case Op::JUMP:
+                stack_.push_back(inst.arg);
+                break;
+            case Op::BOL:
+                if (pos == 0) stack_.push_back(at + 1);
+                break;
+            case Op::EOL:
+                if (pos == size) stack_.push_back(at + 1);
+                break;
+        }
+    }
+}
+
+bool Regex::pike(std::string_view text, size_t from, RegexMatch& match) {
+    size_t size = text.size();
+    bool found = false;
+    current_.clear();
+    next_.clear();
+    uint32_t generation = nextGeneration();
+
+    for (size_t pos = from; ; ++pos) {
+        if (!found) {
+            addThread(current_, 0, pos, pos, size, generation);
+        } else if (current_.empty()) {
+            break;
+        }
+
+        uint32_t nextGen = nextGeneration();
+        for (const Thread& thread : current_) {
+            if (found && thread.start > match.begin) {
+                break;
+            }
+            const Inst& inst = program_[thread.pc];
+            if (inst.op == Op::MATCH) {
+                if (!found || pos > match.end) {
+                    match.begin = thread.start;
+                    match.end = pos;
+                    found = true;
+                }
+            } else if (pos < size && sets_[inst.arg].test(static_cast<uint8_t>(text[pos]))) {
+                addThread(next_, thread.pc + 1, thread.start, pos + 1, size, nextGen);
+            }
+        }
+
+        if (pos == size) {
+            break;
+        }
+        std::swap(current_, next_);
+        next_.clear();
+        generation = nextGen;
+    }
+    return found;
+}
+
+// ================= PATTERN CACHE =================
+
+RegexCache& RegexCache::forThread() {
+    thread_local RegexCache cache;
+    return cache;
+}
+
+Regex& RegexCache::get(std::string_view pattern) {
+    auto it = index_.find(pattern);
+    if (it != index_.end()) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return *entries_.front();
+    }
+
+    auto compiled = std::make_unique<Regex>(pattern);
+    entries_.push_front(std::move(compiled));
+    index_.emplace(entries_.front()->pattern(), entries_.begin());
+
+    if (entries_.size() > kCapacity) {
+        index_.erase(entries_.back()->pattern());
+        entries_.pop_back();
+    }
+    return *entries_.front();
+}
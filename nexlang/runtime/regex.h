@@ -0,0 +1,161 @@
+// Header for the regex engine
+#pragma once
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// ================= REGEX =================
+// Linear-time regular expressions. A pattern compiles to a Thompson NFA
+// that is simulated, never backtracked, so a match costs at most
+// O(text * pattern) whatever the pattern looks like.
+//
+//   matches() runs a lazily built DFA: states are created on first use and
+//   cached, so the hot loop is one table lookup per byte.
+//   search() skips ahead to the pattern's literal prefix (if it has one)
+//   with findString (string_ops), uses the DFA to reject texts with no
+//   match, and only then runs the NFA to find the bounds of the match.
+//
+// Syntax works on bytes:
+//   literals  .  [abc] [^a-z]  \d \w \s \D \W \S  \t \n \r and \<punct>
+//   ( )  (?: )  |  * + ?  {m} {m,} {m,n}  ^ $ (start / end of text)
+// Matches are leftmost-longest (POSIX); groups do not capture.
+//
+// A Regex caches DFA states as it runs, so one object must not be used by
+// two threads at once; RegexCache keeps a separate set per thread.
+
+struct RegexMatch {
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+class Regex {
+public:
+    // Throws std::runtime_error if the pattern is malformed
+    explicit Regex(std::string_view pattern);
+
+    Regex(const Regex&) = delete;
+    Regex& operator=(const Regex&) = delete;
+
+    const std::string& pattern() const { return pattern_; }
+
+    // The whole text matches
+    bool matches(std::string_view text);
+
+    // Leftmost-longest match starting at or after from
+    bool search(std::string_view text, size_t from, RegexMatch& match);
+
+    // Literal every match starts with (may be empty)
+    const std::string& literalPrefix() const { return prefix_; }
+
+private:
+    enum class Op : uint8_t {
+        BYTES,   // consume one byte in sets_[arg], continue at pc + 1
+        SPLIT,   // continue at arg and at arg2 (arg preferred)
+        JUMP,    // continue at arg
+        BOL,     // only at text start, continue at pc + 1
+        EOL,     // only at text end, continue at pc + 1
+        MATCH
+    };
+
+    struct Inst {
+        Op op;
+        uint32_t arg = 0;
+        uint32_t arg2 = 0;
+    };
+
+    // Lazily built DFA. A state is the set of NFA instructions (BYTES, EOL
+    // and MATCH) live after an epsilon closure.
+    struct DfaState {
+        std::vector<uint32_t> insts;
+        bool atStart;        // closure was taken at text start (BOL passes)
+        bool match;          // a match ends here
+        bool matchAtEnd;     // a match ends here if this is the end of text
+    };
+
+    struct Dfa {
+        bool unanchored;     // restart the pattern at every position
+        std::vector<DfaState> states;
+        // Row per state, column per byte class. An entry is the target's
+        // row offset (state * classCount_), with kMatchFlag if a match ends
+        // there, or kUnknown / kDead.
+        std::vector<int32_t> transitions;
+        std::unordered_map<std::string, int32_t> index;   // key(insts, atStart) -> state
+        int32_t start[2] = {-1, -1};   // row offset, by [atStart]
+    };
+
+    static constexpr int32_t kUnknown = -2;
+    static constexpr int32_t kDead = -1;
+    static constexpr int32_t kMatchFlag = 1 << 30;
+    static constexpr int32_t kRowMask = kMatchFlag - 1;
+    static constexpr size_t kMaxDfaStates = 4096;   // then the cache is flushed
+
+    std::string pattern_;
+    std::vector<Inst> program_;
+    std::vector<std::bitset<256>> sets_;
+    uint8_t byteClass_[256];   // bytes no set tells apart share a class
+    size_t classCount_ = 0;
+    std::string prefix_;
+    bool anchoredStart_ = false;   // every match starts at text start
+    Dfa anchored_;
+    Dfa unanchored_;
+
+    // NFA thread: where it is and where its match began
+    struct Thread {
+        uint32_t pc;
+        size_t start;
+    };
+
+    // Scratch reused across calls
+    std::vector<uint32_t> marks_;   // per instruction: generation it was last visited in
+    uint32_t generation_ = 0;
+    std::vector<uint32_t> stack_;
+    std::vector<uint32_t> insts_;
+    std::vector<Thread> current_;
+    std::vector<Thread> next_;
+
+    void computeByteClasses();
+    uint32_t nextGeneration();
+
+    // DFA
+    // Both work on row offsets; step returns a transitions entry
+    int32_t startState(Dfa& dfa, bool atStart);
+    int32_t step(Dfa& dfa, int32_t row, uint8_t byte);
+    int32_t addState(Dfa& dfa, std::vector<uint32_t>& insts, bool atStart);
+    void closure(uint32_t pc, bool atStart, uint32_t generation, std::vector<uint32_t>& out);
+    bool reachesMatchAtEnd(uint32_t pc, bool atStart) const;
+    // Earliest end of any match starting at or after from
+    bool firstMatchEnd(std::string_view text, size_t from, size_t& end);
+
+    // NFA simulation for the bounds of the match
+    bool pike(std::string_view text, size_t from, RegexMatch& match);
+    void addThread(std::vector<Thread>& list, uint32_t pc, size_t start, size_t pos,
+                   size_t size, uint32_t generation);
+
+    friend class RegexCompiler;
+};
+
+// ================= PATTERN CACHE =================
+// Compiled patterns by pattern text, least recently used first out. Each
+// thread has its own cache, so builtins called from parallel blocks never
+// share a Regex and never lock.
+class RegexCache {
+public:
+    static constexpr size_t kCapacity = 64;
+
+    static RegexCache& forThread();
+
+    // Compiles on a miss; the reference is valid until the next get()
+    Regex& get(std::string_view pattern);
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    std::list<std::unique_ptr<Regex>> entries_;   // most recently used first
+    std::unordered_map<std::string_view, std::list<std::unique_ptr<Regex>>::iterator> index_;
+};
@@ -0,0 +1,368 @@
+// SIMD batch operations implementation
+#include "simd_ops.h"
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NEXLANG_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// ================= SCALAR =================
+
+static void addScalar(const double* a, const double* b, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+}
+
+static void mulScalar(const double* a, const double* b, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+}
+
+// Rounded once, like the vector fmadd, so every kernel gives the same bits
+static void fmaScalar(const double* a, const double* b, const double* c, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = std::fma(a[i], b[i], c[i]);
+}
+
+static bool compareOne(double a, double b, CompareOp op) {
+    switch (op) {
+        case CompareOp::LESS:    return a < b;
+        case CompareOp::EQUAL:   return a == b;
+        case CompareOp::GREATER: return a > b;
+    }
+    return false;
+}
+
+static void compareScalar(const double* a, const double* b, double* out, size_t n, CompareOp op) {
+    for (size_t i = 0; i < n; ++i) out[i] = compareOne(a[i], b[i], op) ? 1.0 : 0.0;
+}
+
+static double sumScalar(const double* a, size_t n) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += a[i];
+    return total;
+}
+
+static double minScalar(const double* a, size_t n) {
+    double best = a[0];
+    for (size_t i = 1; i < n; ++i) best = a[i] < best ? a[i] : best;
+    return best;
+}
+
+static double maxScalar(const double* a, size_t n) {
+    double best = a[0];
+    for (size_t i = 1; i < n; ++i) best = a[i] > best ? a[i] : best;
+    return best;
+}
+
+static double dotScalar(const double* a, const double* b, size_t n) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += a[i] * b[i];
+    return total;
+}
+
+static const SimdKernels kScalarKernels = {
+    addScalar, mulScalar, fmaScalar, compareScalar, sumScalar, minScalar, maxScalar, dotScalar
+};
+
+#ifdef NEXLANG_SIMD_X86
+
+// ================= AVX2 =================
+// 4 doubles per vector; tails fall back to the scalar loops
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+AVX2_TARGET static void addAvx2(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    addScalar(a + i, b + i, out + i, n - i);
+}
+
+AVX2_TARGET static void mulAvx2(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    mulScalar(a + i, b + i, out + i, n - i);
+}
+
+AVX2_TARGET static void fmaAvx2(const double* a, const double* b, const double* c, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i),
+                                                  _mm256_loadu_pd(c + i)));
+    }
+    fmaScalar(a + i, b + i, c + i, out + i, n - i);
+}
+
+template <int Predicate>
+AVX2_TARGET static void compareAvx2With(const double* a, const double* b, double* out, size_t n) {
+    const __m256d ones = _mm256_set1_pd(1.0);
+    for (size_t i = 0; i + 4 <= n; i += 4) {
+        __m256d mask = _mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), Predicate);
+        _mm256_storeu_pd(out + i, _mm256_and_pd(mask, ones));
+    }
+}
+
+AVX2_TARGET static void compareAvx2(const double* a, const double* b, double* out, size_t n, CompareOp op) {
+    switch (op) {
+        case CompareOp::LESS:    compareAvx2With<_CMP_LT_OQ>(a, b, out, n); break;
+        case CompareOp::EQUAL:   compareAvx2With<_CMP_EQ_OQ>(a, b, out, n); break;
+        case CompareOp::GREATER: compareAvx2With<_CMP_GT_OQ>(a, b, out, n); break;
+    }
+    size_t done = n & ~size_t(3);
+    compareScalar(a + done, b + done, out + done, n - done, op);
+}
+
+AVX2_TARGET static double horizontalSum(__m256d v) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+AVX2_TARGET static double sumAvx2(const double* a, size_t n) {
+    // Two accumulators hide the add latency
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(a + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(a + i + 4));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(a + i));
+    }
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + sumScalar(a + i, n - i);
+}
+
+// min/max finish with an overlapping load; re-reading elements is harmless
+AVX2_TARGET static double minAvx2(const double* a, size_t n) {
+    if (n < 4) return minScalar(a, n);
+    __m256d best = _mm256_loadu_pd(a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        best = _mm256_min_pd(_mm256_loadu_pd(a + i), best);
+    }
+    if (i < n) {
+        best = _mm256_min_pd(_mm256_loadu_pd(a + n - 4), best);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, best);
+    return minScalar(lanes, 4);
+}
+
+AVX2_TARGET static double maxAvx2(const double* a, size_t n) {
+    if (n < 4) return maxScalar(a, n);
+    __m256d best = _mm256_loadu_pd(a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        best = _mm256_max_pd(_mm256_loadu_pd(a + i), best);
+    }
+    if (i < n) {
+        best = _mm256_max_pd(_mm256_loadu_pd(a + n - 4), best);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, best);
+    return maxScalar(lanes, 4);
+}
+
+AVX2_TARGET static double dotAvx2(const double* a, const double* b, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+    }
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + dotScalar(a + i, b + i, n - i);
+}
+
+static const SimdKernels kAvx2Kernels = {
+    addAvx2, mulAvx2, fmaAvx2, compareAvx2, sumAvx2, minAvx2, maxAvx2, dotAvx2
+};
+
+// ================= AVX-512 =================
+// 8 doubles per vector; tails use masked loads and stores
+
+#define AVX512_TARGET __attribute__((target("avx512f")))
+
+// GCC's AVX-512 headers seed "undefined" vectors from themselves, which trips
+// its own uninitialized-use warnings
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+AVX512_TARGET static __mmask8 tailMask(size_t remaining) {
+    return static_cast<__mmask8>((1u << remaining) - 1);
+}
+
+AVX512_TARGET static void addAvx512(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    if (i < n) {
+        __mmask8 m = tailMask(n - i);
+        _mm512_mask_storeu_pd(out + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+    }
+}
+
+AVX512_TARGET static void mulAvx512(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    if (i < n) {
+        __mmask8 m = tailMask(n - i);
+        _mm512_mask_storeu_pd(out + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+    }
+}
+
+AVX512_TARGET static void fmaAvx512(const double* a, const double* b, const double* c, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i),
+                                                  _mm512_loadu_pd(c + i)));
+    }
+    if (i < n) {
+        __mmask8 m = tailMask(n - i);
+        _mm512_mask_storeu_pd(out + i, m, _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i),
+                                                          _mm512_maskz_loadu_pd(m, c + i)));
+    }
+}
+
+template <int Predicate>
+AVX512_TARGET static void compareAvx512With(const double* a, const double* b, double* out, size_t n) {
+    const __m512d ones = _mm512_set1_pd(1.0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __mmask8 hit = _mm512_cmp_pd_mask(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), Predicate);
+        _mm512_storeu_pd(out + i, _mm512_maskz_mov_pd(hit, ones));
+    }
+    if (i < n) {
+        __mmask8 m = tailMask(n - i);
+        __mmask8 hit = _mm512_mask_cmp_pd_mask(m, _mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i), Predicate);
+        _mm512_mask_storeu_pd(out + i, m, _mm512_maskz_mov_pd(hit, ones));
+    }
+}
+
+AVX512_TARGET static void compareAvx512(const double* a, const double* b, double* out, size_t n, CompareOp op) {
+    switch (op) {
+        case CompareOp::LESS:    compareAvx512With<_CMP_LT_OQ>(a, b, out, n); break;
+        case CompareOp::EQUAL:   compareAvx512With<_CMP_EQ_OQ>(a, b, out, n); break;
+        case CompareOp::GREATER: compareAvx512With<_CMP_GT_OQ>(a, b, out, n); break;
+    }
+}
+
+AVX512_TARGET static double sumAvx512(const double* a, size_t n) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_add_pd(acc0, _mm512_loadu_pd(a + i));
+        acc1 = _mm512_add_pd(acc1, _mm512_loadu_pd(a + i + 8));
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm512_add_pd(acc0, _mm512_loadu_pd(a + i));
+    }
+    if (i < n) {
+        acc1 = _mm512_add_pd(acc1, _mm512_maskz_loadu_pd(tailMask(n - i), a + i));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+
+AVX512_TARGET static double minAvx512(const double* a, size_t n) {
+    if (n < 8) return minScalar(a, n);
+    __m512d best = _mm512_loadu_pd(a);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        best = _mm512_min_pd(_mm512_loadu_pd(a + i), best);
+    }
+    if (i < n) {
+        best = _mm512_min_pd(_mm512_loadu_pd(a + n - 8), best);
+    }
+    return _mm512_reduce_min_pd(best);
+}
+
+AVX512_TARGET static double maxAvx512(const double* a, size_t n) {
+    if (n < 8) return maxScalar(a, n);
+    __m512d best = _mm512_loadu_pd(a);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        best = _mm512_max_pd(_mm512_loadu_pd(a + i), best);
+    }
+    if (i < n) {
+        best = _mm512_max_pd(_mm512_loadu_pd(a + n - 8), best);
+    }
+    return _mm512_reduce_max_pd(best);
+}
+
+AVX512_TARGET static double dotAvx512(const double* a, const double* b, size_t n) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+    }
+    if (i < n) {
+        __mmask8 m = tailMask(n - i);
+        acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i), acc1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+
+static const SimdKernels kAvx512Kernels = {
+    addAvx512, mulAvx512, fmaAvx512, compareAvx512, sumAvx512, minAvx512, maxAvx512, dotAvx512
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // NEXLANG_SIMD_X86
+
+// ================= DISPATCH =================
+
+static SimdLevel detectSimdLevel() {
+#ifdef NEXLANG_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+SimdLevel simdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+const SimdKernels& simdKernels(SimdLevel level) {
+#ifdef NEXLANG_SIMD_X86
+    switch (level) {
+        case SimdLevel::AVX512: return kAvx512Kernels;
+        case SimdLevel::AVX2:   return kAvx2Kernels;
+        case SimdLevel::SCALAR: break;
+    }
+#else
+    (void)level;
+#endif
+    return kScalarKernels;
+}
+
+const SimdKernels& simdKernels() {
+    static const SimdKernels& kernels = simdKernels(simdLevel());
+    return kernels;
+}
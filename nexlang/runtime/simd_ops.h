@@ -0,0 +1,46 @@
+// Header for SIMD batch operations
+#pragma once
+#include <cstddef>
+
+// ================= BATCH KERNELS =================
+// Element-wise and reduction kernels over contiguous doubles (the FLOAT
+// layout of ArrayRep). Each kernel has a scalar, an AVX2 and an AVX-512
+// implementation; the best one the CPU supports is picked once, on first use.
+// Outputs may alias inputs.
+//
+// Reductions split the data across vector lanes, so sums can differ from a
+// strict left-to-right sum in the last bits.
+
+enum class SimdLevel {
+    SCALAR,
+    AVX2,     // AVX2 + FMA
+    AVX512    // AVX-512F
+};
+
+enum class CompareOp {
+    LESS,
+    EQUAL,
+    GREATER
+};
+
+struct SimdKernels {
+    void (*add)(const double* a, const double* b, double* out, size_t n);
+    void (*mul)(const double* a, const double* b, double* out, size_t n);
+    // out = a * b + c
+    void (*fma)(const double* a, const double* b, const double* c, double* out, size_t n);
+    // out[i] = (a[i] op b[i]) ? 1.0 : 0.0
+    void (*compare)(const double* a, const double* b, double* out, size_t n, CompareOp op);
+    double (*sum)(const double* a, size_t n);
+    // n must be > 0
+    double (*min)(const double* a, size_t n);
+    double (*max)(const double* a, size_t n);
+    double (*dot)(const double* a, const double* b, size_t n);
+};
+
+// Kernels for the running CPU
+const SimdKernels& simdKernels();
+
+// Kernels for a specific level (falls back to scalar if not compiled in)
+const SimdKernels& simdKernels(SimdLevel level);
+
+SimdLevel simdLevel();
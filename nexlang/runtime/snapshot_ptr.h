@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ================= SNAPSHOT POINTER =================
+// Read-mostly publication of an immutable T (RCU style).
+//
+// Readers call load() and get the current version with a single acquire
+// load: no locks, no refcounts. Writers are serialized; each update copies
+// the current version, edits the copy and publishes it atomically.
+// Superseded versions are retired, not freed, because a reader may still be
+// using them; they are released by reclaim() or when the SnapshotPtr dies.
+template <typename T>
+class SnapshotPtr {
+public:
+    SnapshotPtr() : current_(nullptr) {}
+
+    explicit SnapshotPtr(std::unique_ptr<T> initial) : current_(nullptr) {
+        publish(std::move(initial));
+    }
+
+    SnapshotPtr(const SnapshotPtr&) = delete;
+    SnapshotPtr& operator=(const SnapshotPtr&) = delete;
+
+    // Current version (nullptr until the first publish)
+    const T* load() const {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    // Replace the current version wholesale
+    void publish(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        current_.store(next.get(), std::memory_order_release);
+        versions_.push_back(std::move(next));
+    }
+
+    // Copy the current version (or default-construct one), let fn edit it,
+    // then publish the result
+    template <typename Fn>
+    void update(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        const T* current = current_.load(std::memory_order_relaxed);
+        auto next = current ? std::make_unique<T>(*current) : std::make_unique<T>();
+        fn(*next);
+        current_.store(next.get(), std::memory_order_release);
+        versions_.push_back(std::move(next));
+    }
+
+    // Free retired versions. Only call when no reader can still hold one
+    // (e.g. after worker threads have been joined).
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if (versions_.size() > 1) {
+            versions_.erase(versions_.begin(), versions_.end() - 1);
+        }
+    }
+
+private:
+    std::atomic<const T*> current_;
+    std::mutex writeMutex_;
+    std::vector<std::unique_ptr<T>> versions_;   // versions_.back() is current
+};
@@ -0,0 +1,224 @@
+// Array sort implementation
+#include "sort.h"
+#include <functional>
+#include <vector>
+#include "thread_pool.h"
+
+// Below this many elements a comparison sort beats the radix passes
+static constexpr size_t kRadixMinimum = 1024;
+
+// ================= RADIX SORT =================
+
+// LSD radix sort on 64-bit keys, 11 bits per pass. All digit histograms
+// are built in one read of the data; a pass in which every key has the
+// same digit is skipped (small or clustered values often need only a few
+// passes). Stable. buffer must hold n elements.
+template <typename T, typename KeyOf>
+static void radixSort(T* data, T* buffer, size_t n, KeyOf keyOf) {
+    constexpr unsigned kBits = 11;
+    constexpr size_t kBuckets = size_t(1) << kBits;
+    constexpr unsigned kPasses = (64 + kBits - 1) / kBits;
+    std::vector<size_t> counts(kPasses * kBuckets, 0);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t key = keyOf(data[i]);
+        for (unsigned pass = 0; pass < kPasses; ++pass) {
+            ++counts[pass * kBuckets + ((key >> (pass * kBits)) & (kBuckets - 1))];
+        }
+    }
+
+    T* from = data;
+    T* to = buffer;
+    for (unsigned pass = 0; pass < kPasses; ++pass) {
+        size_t* count = counts.data() + pass * kBuckets;
+        unsigned shift = pass * kBits;
+        if (count[(keyOf(from[0]) >> shift) & (kBuckets - 1)] == n) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            size_t c = count[bucket];
+            count[bucket] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            to[count[(keyOf(from[i]) >> shift) & (kBuckets - 1)]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != data) {
+        std::copy(from, from + n, data);
+    }
+}
+
+// ================= PARALLEL SORT =================
+
+// Elements taken from a for the first k outputs of the stable merge of a
+// and b (ties go to a)
+template <typename T, typename Less>
+static size_t mergeSplit(const T* a, size_t na, const T* b, size_t nb, size_t k, Less& less) {
+    size_t lo = k > nb ? k - nb : 0;
+    size_t hi = std::min(k, na);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (!less(b[k - i - 1], a[i])) {
+            lo = i + 1;   // a[i] is written before b[k - i - 1]
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+// Sorts one chunk per pool thread with sortChunk, then merges the chunks
+// pairwise. Each merge round is cut into as many pieces as there are
+// chunks (split points found by binary search), so every round keeps all
+// threads busy. Merging is stable; the result is stable if sortChunk is.
+template <typename T, typename Less>
+static void parallelSort(T* data, size_t n, Less less, const std::function<void(T*, size_t)>& sortChunk) {
+    ThreadPool& pool = ThreadPool::getInstance();
+    size_t chunks = 1;
+    while (chunks * 2 <= pool.concurrency() && n / (chunks * 2) >= kParallelSortThreshold / 4) {
+        chunks *= 2;
+    }
+    if (chunks == 1) {
+        sortChunk(data, n);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) {
+        bounds[i] = n / chunks * i + std::min(i, n % chunks);
+    }
+    pool.run(chunks, [&](size_t chunk) {
+        sortChunk(data + bounds[chunk], bounds[chunk + 1] - bounds[chunk]);
+    });
+
+    std::vector<T> buffer(n);
+    T* from = data;
+    T* to = buffer.data();
+    for (size_t width = 1; width < chunks; width *= 2) {
+        size_t pieces = 2 * width;   // per merged pair, so chunks pieces per round
+        pool.run(chunks, [&](size_t task) {
+            size_t pair = task / pieces;
+            size_t piece = task % pieces;
+            size_t lo = bounds[pair * pieces];
+            size_t mid = bounds[pair * pieces + width];
+            size_t hi = bounds[(pair + 1) * pieces];
+            const T* a = from + lo;
+            const T* b = from + mid;
+            size_t na = mid - lo;
+            size_t nb = hi - mid;
+            size_t k0 = (na + nb) * piece / pieces;
+            size_t k1 = (na + nb) * (piece + 1) / pieces;
+            size_t i0 = mergeSplit(a, na, b, nb, k0, less);
+            size_t i1 = mergeSplit(a, na, b, nb, k1, less);
+            std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), to + lo + k0, less);
+        });
+        std::swap(from, to);
+    }
+    if (from != data) {
+        std::copy(from, from + n, data);
+    }
+}
+
+// ================= SORTS =================
+
+static void sortKeys(uint64_t* keys, size_t n) {
+    if (n < kRadixMinimum) {
+        pdqSort(keys, keys + n, std::less<uint64_t>());
+        return;
+    }
+    std::vector<uint64_t> buffer(n);
+    radixSort(keys, buffer.data(), n, [](uint64_t key) { return key; });
+}
+
+void sortFloats(double* data, size_t n) {
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = floatSortKey(data[i]);
+    }
+    if (n < kParallelSortThreshold) {
+        sortKeys(keys.data(), n);
+    } else {
+        parallelSort<uint64_t>(keys.data(), n, std::less<uint64_t>(), &sortKeys);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = floatFromSortKey(keys[i]);
+    }
+}
+
+void sortStrings(std::string_view* data, size_t n) {
+    auto sortChunk = [](std::string_view* chunk, size_t size) {
+        pdqSort(chunk, chunk + size, std::less<std::string_view>());
+    };
+    if (n < kParallelSortThreshold) {
+        sortChunk(data, n);
+    } else {
+        parallelSort<std::string_view>(data, n, std::less<std::string_view>(), sortChunk);
+    }
+}
+
+void sortFloatEntries(FloatSortEntry* entries, size_t n) {
+    auto less = [](const FloatSortEntry& a, const FloatSortEntry& b) { return a.key < b.key; };
+    auto sortChunk = [](FloatSortEntry* chunk, size_t size) {
+        if (size < kRadixMinimum) {
+            // Index breaks ties, so the comparison sort is stable too
+            pdqSort(chunk, chunk + size, [](const FloatSortEntry& a, const FloatSortEntry& b) {
+                return a.key < b.key || (a.key == b.key && a.index < b.index);
+            });
+            return;
+        }
+        std::vector<FloatSortEntry> buffer(size);
+        radixSort(chunk, buffer.data(), size, [](const FloatSortEntry& entry) { return entry.key; });
+    };
+    if (n < kParallelSortThreshold) {
+        sortChunk(entries, n);
+    } else {
+        parallelSort<FloatSortEntry>(entries, n, less, sortChunk);
+    }
+}
+
+void sortStringEntries(StringSortEntry* entries, size_t n, bool stable) {
+    auto less = [](const StringSortEntry& a, const StringSortEntry& b) { return a.key < b.key; };
+    std::function<void(StringSortEntry*, size_t)> sortChunk;
+    if (stable) {
+        sortChunk = [less](StringSortEntry* chunk, size_t size) { std::stable_sort(chunk, chunk + size, less); };
+    } else {
+        sortChunk = [less](StringSortEntry* chunk, size_t size) { pdqSort(chunk, chunk + size, less); };
+    }
+    if (n < kParallelSortThreshold) {
+        sortChunk(entries, n);
+    } else {
+        parallelSort<StringSortEntry>(entries, n, less, sortChunk);
+    }
+}
+
+// ================= TOP K =================
+
+// Selects the k largest (introselect) and sorts only those
+template <typename T, typename Greater>
+static void topK(T* data, size_t n, size_t k, Greater greater) {
+    k = std::min(k, n);
+    if (k == 0) {
+        return;
+    }
+    if (k < n) {
+        std::nth_element(data, data + (k - 1), data + n, greater);
+    }
+    pdqSort(data, data + k, greater);
+}
+
+void topFloats(double* data, size_t n, size_t k) {
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = floatSortKey(data[i]);
+    }
+    topK(keys.data(), n, k, std::greater<uint64_t>());
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = floatFromSortKey(keys[i]);
+    }
+}
+
+void topStrings(std::string_view* data, size_t n, size_t k) {
+    topK(data, n, k, std::greater<std::string_view>());
+}
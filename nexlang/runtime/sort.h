@@ -0,0 +1,273 @@
+// Header for the array sorts
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+// ================= SORTS =================
+// Sorts behind the Sort* builtins.
+//   numbers  - LSD radix sort on the IEEE bits, flipped so that unsigned
+//              order is numeric order (-inf < ... < -0 < +0 < ... < +inf,
+//              NaNs by sign at the ends)
+//   strings  - pattern-defeating quicksort (byte order)
+// Above kParallelSortThreshold elements the data is cut into one chunk per
+// thread of the ThreadPool; the chunks are sorted in parallel and merged
+// pairwise, each merge again split across all threads.
+
+constexpr size_t kParallelSortThreshold = 64 * 1024;
+
+// Unsigned key whose order is the numeric order of value
+inline uint64_t floatSortKey(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+inline double floatFromSortKey(uint64_t key) {
+    uint64_t bits = (key >> 63) ? key & ~(uint64_t(1) << 63) : ~key;
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Element of a sort by key: the key and the element's original index
+struct FloatSortEntry {
+    uint64_t key;   // floatSortKey
+    size_t index;
+};
+
+struct StringSortEntry {
+    std::string_view key;
+    size_t index;
+};
+
+// Ascending, in place
+void sortFloats(double* data, size_t n);
+void sortStrings(std::string_view* data, size_t n);
+
+// Orders entries by key. Radix sort is stable, so float keys always keep
+// equal keys in input order; string keys do when stable is set (merge
+// sort instead of quicksort).
+void sortFloatEntries(FloatSortEntry* entries, size_t n);
+void sortStringEntries(StringSortEntry* entries, size_t n, bool stable);
+
+// Moves the k largest elements to the front, largest first; the order of
+// the rest is unspecified
+void topFloats(double* data, size_t n, size_t k);
+void topStrings(std::string_view* data, size_t n, size_t k);
+
+// ================= PDQSORT =================
+// Pattern-defeating quicksort: introsort with a median-of-3 (ninther for
+// large ranges) pivot, a partition that notices already-partitioned
+// input (sorted runs finish in linear time), pivots equal to the previous
+// one grouped in one pass (many duplicates), and shuffles plus a heapsort
+// fallback once partitions keep coming out unbalanced, so the worst case
+// stays O(n log n). Not stable.
+
+constexpr ptrdiff_t kPdqInsertionSortLimit = 24;
+constexpr ptrdiff_t kPdqNintherThreshold = 128;
+constexpr size_t kPdqPartialInsertionLimit = 8;   // element moves
+
+template <typename T, typename Less>
+void pdqInsertionSort(T* begin, T* end, Less& less) {
+    if (begin == end) return;
+    for (T* cur = begin + 1; cur != end; ++cur) {
+        if (less(*cur, *(cur - 1))) {
+            T tmp = std::move(*cur);
+            T* hole = cur;
+            do {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            } while (hole != begin && less(tmp, *(hole - 1)));
+            *hole = std::move(tmp);
+        }
+    }
+}
+
+// begin[-1] is no greater than any element of the range
+template <typename T, typename Less>
+void pdqUnguardedInsertionSort(T* begin, T* end, Less& less) {
+    if (begin == end) return;
+    for (T* cur = begin + 1; cur != end; ++cur) {
+        if (less(*cur, *(cur - 1))) {
+            T tmp = std::move(*cur);
+            T* hole = cur;
+            do {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            } while (less(tmp, *(hole - 1)));
+            *hole = std::move(tmp);
+        }
+    }
+}
+
+// Gives up (false) once more than kPdqPartialInsertionLimit moves were needed
+template <typename T, typename Less>
+bool pdqPartialInsertionSort(T* begin, T* end, Less& less) {
+    if (begin == end) return true;
+    size_t moves = 0;
+    for (T* cur = begin + 1; cur != end; ++cur) {
+        if (less(*cur, *(cur - 1))) {
+            T tmp = std::move(*cur);
+            T* hole = cur;
+            do {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            } while (hole != begin && less(tmp, *(hole - 1)));
+            *hole = std::move(tmp);
+            moves += static_cast<size_t>(cur - hole);
+            if (moves > kPdqPartialInsertionLimit) return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Less>
+void pdqSort2(T* a, T* b, Less& less) {
+    if (less(*b, *a)) std::swap(*a, *b);
+}
+
+template <typename T, typename Less>
+void pdqSort3(T* a, T* b, T* c, Less& less) {
+    pdqSort2(a, b, less);
+    pdqSort2(b, c, less);
+    pdqSort2(a, b, less);
+}
+
+// Partitions around the pivot *begin into [< pivot] pivot [>= pivot].
+// Returns the pivot's final position and whether no element had to move.
+// Needs an element >= pivot after the range's first element (the median
+// selection guarantees one).
+template <typename T, typename Less>
+std::pair<T*, bool> pdqPartitionRight(T* begin, T* end, Less& less) {
+    T pivot = std::move(*begin);
+    T* first = begin;
+    T* last = end;
+    while (less(*++first, pivot)) {}
+    if (first - 1 == begin) {
+        while (first < last && !less(*--last, pivot)) {}
+    } else {
+        while (!less(*--last, pivot)) {}
+    }
+    bool alreadyPartitioned = first >= last;
+    while (first < last) {
+        std::swap(*first, *last);
+        while (less(*++first, pivot)) {}
+        while (!less(*--last, pivot)) {}
+    }
+    T* pivotPos = first - 1;
+    *begin = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return {pivotPos, alreadyPartitioned};
+}
+
+// Partitions into [== pivot] [> pivot] for a pivot equal to begin[-1]
+// (the previous pivot); returns the last element equal to the pivot
+template <typename T, typename Less>
+T* pdqPartitionLeft(T* begin, T* end, Less& less) {
+    T pivot = std::move(*begin);
+    T* first = begin;
+    T* last = end;
+    while (less(pivot, *--last)) {}
+    if (last + 1 == end) {
+        while (first < last && !less(pivot, *++first)) {}
+    } else {
+        while (!less(pivot, *++first)) {}
+    }
+    while (first < last) {
+        std::swap(*first, *last);
+        while (less(pivot, *--last)) {}
+        while (!less(pivot, *++first)) {}
+    }
+    T* pivotPos = last;
+    *begin = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return pivotPos;
+}
+
+// Swaps a few elements of an unbalanced partition to break the pattern
+template <typename T>
+void pdqBreakPatterns(T* begin, T* end) {
+    ptrdiff_t size = end - begin;
+    if (size < kPdqInsertionSortLimit) return;
+    ptrdiff_t quarter = size / 4;
+    std::swap(begin[0], begin[quarter]);
+    std::swap(end[-1], end[-quarter]);
+    if (size > kPdqNintherThreshold) {
+        std::swap(begin[1], begin[quarter + 1]);
+        std::swap(begin[2], begin[quarter + 2]);
+        std::swap(end[-2], end[-(quarter + 1)]);
+        std::swap(end[-3], end[-(quarter + 2)]);
+    }
+}
+
+template <typename T, typename Less>
+void pdqLoop(T* begin, T* end, Less& less, int badAllowed, bool leftmost) {
+    for (;;) {
+        ptrdiff_t size = end - begin;
+        if (size < kPdqInsertionSortLimit) {
+            if (leftmost) {
+                pdqInsertionSort(begin, end, less);
+            } else {
+                pdqUnguardedInsertionSort(begin, end, less);
+            }
+            return;
+        }
+
+        // Median of 3, or ninther, moved to *begin
+        ptrdiff_t half = size / 2;
+        if (size > kPdqNintherThreshold) {
+            pdqSort3(begin, begin + half, end - 1, less);
+            pdqSort3(begin + 1, begin + (half - 1), end - 2, less);
+            pdqSort3(begin + 2, begin + (half + 1), end - 3, less);
+            pdqSort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+            std::swap(*begin, *(begin + half));
+        } else {
+            pdqSort3(begin + half, begin, end - 1, less);
+        }
+
+        // The pivot equals the previous pivot: everything up to it is
+        // equal and already in place
+        if (!leftmost && !less(*(begin - 1), *begin)) {
+            begin = pdqPartitionLeft(begin, end, less) + 1;
+            continue;
+        }
+
+        std::pair<T*, bool> split = pdqPartitionRight(begin, end, less);
+        T* pivotPos = split.first;
+        ptrdiff_t leftSize = pivotPos - begin;
+        ptrdiff_t rightSize = end - (pivotPos + 1);
+
+        if (leftSize < size / 8 || rightSize < size / 8) {
+            if (--badAllowed == 0) {
+                std::make_heap(begin, end, less);
+                std::sort_heap(begin, end, less);
+                return;
+            }
+            pdqBreakPatterns(begin, pivotPos);
+            pdqBreakPatterns(pivotPos + 1, end);
+        } else if (split.second && pdqPartialInsertionSort(begin, pivotPos, less) &&
+                   pdqPartialInsertionSort(pivotPos + 1, end, less)) {
+            return;
+        }
+
+        // Recurse into the left part, loop on the right
+        pdqLoop(begin, pivotPos, less, badAllowed, leftmost);
+        begin = pivotPos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename T, typename Less>
+void pdqSort(T* begin, T* end, Less less) {
+    size_t size = static_cast<size_t>(end - begin);
+    if (size < 2) {
+        return;
+    }
+    int log2 = 0;
+    while (size >>= 1) ++log2;
+    pdqLoop(begin, end, less, log2, true);
+}
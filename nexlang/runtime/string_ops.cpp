@@ -1,3 +1,252 @@
-// Placeholder for string operations implementation
+// String operations implementation
+#include "string_ops.h"
+#include <cstdint>
+#include <cstring>
 
-// Implement string operations here
+// NEXLANG_SCALAR_STRINGS forces the scalar loops (the tests build both)
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__)) && !defined(NEXLANG_SCALAR_STRINGS)
+#define NEXLANG_STRING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef NEXLANG_STRING_SSE2
+static inline __m128i load16(const char* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+static inline unsigned lowestBit(unsigned mask) {
+    return static_cast<unsigned>(__builtin_ctz(mask));
+}
+#endif
+
+// ================= SEARCH =================
+
+size_t findByte(std::string_view text, char byte, size_t from) {
+    size_t n = text.size();
+    if (from >= n) {
+        return kNotFound;
+    }
+    const char* s = text.data();
+    size_t i = from;
+#ifdef NEXLANG_STRING_SSE2
+    const __m128i target = _mm_set1_epi8(byte);
+    for (; i + 16 <= n; i += 16) {
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(load16(s + i), target)));
+        if (mask) {
+            return i + lowestBit(mask);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (s[i] == byte) return i;
+    }
+    return kNotFound;
+}
+
+// Compares the needle's first and last byte at 16 candidate positions at
+// once and only checks the whole needle where both agree
+size_t findString(std::string_view text, std::string_view needle, size_t from) {
+    size_t n = text.size();
+    size_t m = needle.size();
+    if (m == 0) {
+        return from <= n ? from : kNotFound;
+    }
+    if (m == 1) {
+        return findByte(text, needle[0], from);
+    }
+    if (n < m || from > n - m) {
+        return kNotFound;
+    }
+
+    const char* s = text.data();
+    size_t i = from;
+#ifdef NEXLANG_STRING_SSE2
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    for (; i + 16 + m - 1 <= n; i += 16) {
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(load16(s + i), first), _mm_cmpeq_epi8(load16(s + i + m - 1), last))));
+        while (mask) {
+            size_t at = i + lowestBit(mask);
+            if (std::memcmp(s + at + 1, needle.data() + 1, m - 2) == 0) {
+                return at;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i + m <= n; ++i) {
+        if (s[i] == needle[0] && std::memcmp(s + i, needle.data(), m) == 0) {
+            return i;
+        }
+    }
+    return kNotFound;
+}
+
+size_t countString(std::string_view text, std::string_view needle) {
+    if (needle.empty()) {
+        return 0;
+    }
+    size_t count = 0;
+    for (size_t at = findString(text, needle); at != kNotFound; at = findString(text, needle, at + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+// ================= REPLACE / SPLIT =================
+
+size_t replaceAllSize(std::string_view text, std::string_view needle, std::string_view replacement) {
+    if (needle.empty()) {
+        return text.size();
+    }
+    size_t count = countString(text, needle);
+    return text.size() - count * needle.size() + count * replacement.size();
+}
+
+size_t replaceAll(std::string_view text, std::string_view needle, std::string_view replacement, char* out) {
+    char* cursor = out;
+    size_t copied = 0;
+    if (!needle.empty()) {
+        for (size_t at = findString(text, needle); at != kNotFound;
+             at = findString(text, needle, at + needle.size())) {
+            std::memcpy(cursor, text.data() + copied, at - copied);
+            cursor += at - copied;
+            std::memcpy(cursor, replacement.data(), replacement.size());
+            cursor += replacement.size();
+            copied = at + needle.size();
+        }
+    }
+    std::memcpy(cursor, text.data() + copied, text.size() - copied);
+    cursor += text.size() - copied;
+    return static_cast<size_t>(cursor - out);
+}
+
+void splitString(std::string_view text, std::string_view delimiter, std::vector<std::string_view>& pieces) {
+    if (delimiter.empty()) {
+        pieces.push_back(text);
+        return;
+    }
+    size_t start = 0;
+    for (size_t at = findString(text, delimiter); at != kNotFound;
+         at = findString(text, delimiter, start)) {
+        pieces.push_back(text.substr(start, at - start));
+        start = at + delimiter.size();
+    }
+    pieces.push_back(text.substr(start));
+}
+
+// ================= CASE / WHITESPACE =================
+
+// Flips bit 0x20 of bytes in [low, high]. Signed compares leave bytes
+// >= 0x80 (negative) alone.
+static void flipCase(const char* in, size_t size, char* out, char low, char high) {
+    size_t i = 0;
+#ifdef NEXLANG_STRING_SSE2
+    const __m128i below = _mm_set1_epi8(static_cast<char>(low - 1));
+    const __m128i above = _mm_set1_epi8(static_cast<char>(high + 1));
+    const __m128i bit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes = load16(in + i);
+        __m128i inRange = _mm_and_si128(_mm_cmpgt_epi8(bytes, below), _mm_cmplt_epi8(bytes, above));
+        __m128i flipped = _mm_xor_si128(bytes, _mm_and_si128(inRange, bit));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), flipped);
+    }
+#endif
+    for (; i < size; ++i) {
+        char c = in[i];
+        out[i] = (c >= low && c <= high) ? static_cast<char>(c ^ 0x20) : c;
+    }
+}
+
+void toUpperAscii(const char* in, size_t size, char* out) {
+    flipCase(in, size, out, 'a', 'z');
+}
+
+void toLowerAscii(const char* in, size_t size, char* out) {
+    flipCase(in, size, out, 'A', 'Z');
+}
+
+static bool isAsciiSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+std::string_view trimAscii(std::string_view text) {
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && isAsciiSpace(text[begin])) ++begin;
+    while (end > begin && isAsciiSpace(text[end - 1])) --end;
+    return text.substr(begin, end - begin);
+}
+
+// ================= UTF-8 =================
+
+// Length of the well-formed sequence starting at s[i] (i < n), or 0
+static size_t utf8Sequence(const unsigned char* s, size_t i, size_t n) {
+    unsigned char lead = s[i];
+    size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;   // allowed range of the second byte
+    if (lead < 0x80) {
+        return 1;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) low = 0xA0;          // overlong
+        else if (lead == 0xED) high = 0x9F;    // surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) low = 0x90;          // overlong
+        else if (lead == 0xF4) high = 0x8F;    // past U+10FFFF
+    } else {
+        return 0;
+    }
+    if (n - i < length || s[i + 1] < low || s[i + 1] > high) {
+        return 0;
+    }
+    for (size_t k = 2; k < length; ++k) {
+        if ((s[i + k] & 0xC0) != 0x80) return 0;
+    }
+    return length;
+}
+
+bool validUtf8(std::string_view text) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text.data());
+    size_t n = text.size();
+    size_t i = 0;
+    while (i < n) {
+#ifdef NEXLANG_STRING_SSE2
+        // Skip ASCII 16 bytes at a time
+        if (i + 16 <= n && _mm_movemask_epi8(load16(text.data() + i)) == 0) {
+            i += 16;
+            continue;
+        }
+#endif
+        size_t length = utf8Sequence(s, i, n);
+        if (length == 0) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+size_t utf8Length(std::string_view text) {
+    const char* s = text.data();
+    size_t n = text.size();
+    size_t continuation = 0;
+    size_t i = 0;
+#ifdef NEXLANG_STRING_SSE2
+    // Continuation bytes 0x80..0xBF are the signed bytes below -64
+    const __m128i limit = _mm_set1_epi8(-64);
+    for (; i + 16 <= n; i += 16) {
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(load16(s + i), limit)));
+        continuation += static_cast<size_t>(__builtin_popcount(mask));
+    }
+#endif
+    for (; i < n; ++i) {
+        if ((static_cast<unsigned char>(s[i]) & 0xC0) == 0x80) ++continuation;
+    }
+    return n - continuation;
+}
@@ -1,4 +1,62 @@
 // Header for string operations
 #pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
 
-// Declare string operation functions here
+// ================= STRING OPERATIONS =================
+// Byte-oriented string primitives. The scans use SSE2 (16 bytes per step;
+// always present on x86-64) and fall back to scalar loops elsewhere or when
+// NEXLANG_SCALAR_STRINGS is defined.
+// Functions that produce text write into a caller-provided buffer of the
+// size the matching *Size() function reports, so a builtin can allocate its
+// result exactly once and fill it in place.
+
+constexpr size_t kNotFound = std::string_view::npos;
+
+// ================= SEARCH =================
+
+// First occurrence of byte at or after from, or kNotFound
+size_t findByte(std::string_view text, char byte, size_t from = 0);
+
+// First occurrence of needle at or after from, or kNotFound. An empty
+// needle is found at from.
+size_t findString(std::string_view text, std::string_view needle, size_t from = 0);
+
+inline bool containsString(std::string_view text, std::string_view needle) {
+    return findString(text, needle) != kNotFound;
+}
+
+// Non-overlapping occurrences of needle (0 for an empty needle)
+size_t countString(std::string_view text, std::string_view needle);
+
+// ================= REPLACE / SPLIT =================
+
+// Length of text with every non-overlapping needle replaced
+size_t replaceAllSize(std::string_view text, std::string_view needle, std::string_view replacement);
+
+// Writes the replaced text to out (replaceAllSize bytes); returns the bytes
+// written. An empty needle replaces nothing.
+size_t replaceAll(std::string_view text, std::string_view needle, std::string_view replacement, char* out);
+
+// Appends the pieces of text between delimiters to pieces (views into
+// text). An empty delimiter yields the whole text as one piece.
+void splitString(std::string_view text, std::string_view delimiter, std::vector<std::string_view>& pieces);
+
+// ================= CASE / WHITESPACE =================
+
+// ASCII letters only; other bytes (including UTF-8) are copied unchanged.
+// out may be the same buffer as in.
+void toUpperAscii(const char* in, size_t size, char* out);
+void toLowerAscii(const char* in, size_t size, char* out);
+
+// text without leading and trailing ASCII whitespace (no copy)
+std::string_view trimAscii(std::string_view text);
+
+// ================= UTF-8 =================
+
+// Well-formed UTF-8: no overlong forms, surrogates or code points past U+10FFFF
+bool validUtf8(std::string_view text);
+
+// Code points in valid UTF-8 text (bytes that are not continuation bytes)
+size_t utf8Length(std::string_view text);
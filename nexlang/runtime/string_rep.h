@@ -0,0 +1,267 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <vector>
+#include "allocator.h"
+
+// ================= STRING REP =================
+// Immutable, refcounted heap string used by STRING Values that do not fit
+// inline. Length is fixed at creation; the hash is computed on first use and
+// cached.
+//
+// The numeric interpretation of the text (string-first semantics mean "10"
+// is routinely used as a number) is also parsed once and cached.
+//
+// A FLAT rep stores its characters right after the header in the same
+// allocation (NUL-terminated), optionally with spare capacity so a uniquely
+// owned rep can be appended to in place. A CONCAT rep is a rope node: it only records
+// its two children, so appending to a long string is O(1). The bytes are
+// assembled the first time a consumer needs them contiguous (data()/view());
+// the children are then dropped and the node behaves like a flat string.
+struct StringRep {
+    enum class Kind : uint8_t {
+        FLAT,
+        CONCAT
+    };
+
+    mutable std::atomic<uint32_t> refCount{1};
+    size_t size;        // only grows through tryAppend()
+    const Kind kind;
+
+    // New FLAT rep holding a + b, with room for at least `capacity` bytes
+    static StringRep* create(std::string_view a, std::string_view b = {}, size_t capacity = 0) {
+        size_t total = a.size() + b.size();
+        if (capacity < total) {
+            capacity = total;
+        }
+        void* mem = runtimeAllocate(sizeof(StringRep) + capacity + 1);
+        StringRep* rep = new (mem) StringRep(Kind::FLAT, total);
+        rep->capacity_ = capacity;
+        char* out = reinterpret_cast<char*>(rep + 1);
+        if (!a.empty()) std::memcpy(out, a.data(), a.size());
+        if (!b.empty()) std::memcpy(out + a.size(), b.data(), b.size());
+        out[total] = '\0';
+        rep->data_.store(out, std::memory_order_relaxed);
+        return rep;
+    }
+
+    // New FLAT rep of `length` bytes, to be filled through buffer() before
+    // it is shared
+    static StringRep* createBuffer(size_t length) {
+        StringRep* rep = create({}, {}, length);
+        rep->size = length;
+        rep->buffer()[length] = '\0';
+        return rep;
+    }
+    
+    // New CONCAT rep; takes over one reference to each child
+    static StringRep* concat(StringRep* left, StringRep* right) {
+        void* mem = runtimeAllocate(sizeof(StringRep));
+        StringRep* rep = new (mem) StringRep(Kind::CONCAT, left->size + right->size);
+        rep->left_ = left;
+        rep->right_ = right;
+        return rep;
+    }
+
+    void retain() const {
+        refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Drop one reference. Rope children are torn down iteratively, so a long
+    // chain of appends cannot overflow the stack.
+    static void release(const StringRep* rep) {
+        std::vector<const StringRep*> pending;
+        while (rep) {
+            if (rep->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (rep->left_) pending.push_back(rep->left_);
+                if (rep->right_) pending.push_back(rep->right_);
+                destroy(rep);
+            }
+            if (pending.empty()) {
+                break;
+            }
+            rep = pending.back();
+            pending.pop_back();
+        }
+    }
+
+    // Contiguous NUL-terminated bytes (flattens a rope on first call)
+    const char* data() const {
+        const char* d = data_.load(std::memory_order_acquire);
+        return d ? d : flatten();
+    }
+
+    std::string_view view() const {
+        return std::string_view(data(), size);
+    }
+
+    // Append in place. Only succeeds on a FLAT rep nobody else references
+    // whose spare capacity fits s; the cached hash and parse are reset.
+    bool tryAppend(std::string_view s) {
+        if (kind != Kind::FLAT || size + s.size() > capacity_ ||
+            refCount.load(std::memory_order_acquire) != 1) {
+            return false;
+        }
+        char* out = reinterpret_cast<char*>(this + 1);
+        if (!s.empty()) std::memmove(out + size, s.data(), s.size());
+        size += s.size();
+        out[size] = '\0';
+        hash_.store(0, std::memory_order_relaxed);
+        numericState_.store(NUMERIC_UNKNOWN, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Writable bytes of a FLAT rep nobody else references yet
+    char* buffer() {
+        return reinterpret_cast<char*>(this + 1);
+    }
+
+    bool isFlat() const {
+        return data_.load(std::memory_order_acquire) != nullptr;
+    }
+
+    size_t hash() const {
+        size_t h = hash_.load(std::memory_order_relaxed);
+        if (h == 0) {
+            h = hashChars(view());
+            hash_.store(h, std::memory_order_relaxed);
+        }
+        return h;
+    }
+
+    // Cached numeric parse: true and out = value if the whole text is a number
+    bool number(double& out, bool (*parse)(std::string_view, double&)) const {
+        uint8_t state = numericState_.load(std::memory_order_acquire);
+        if (state == NUMERIC_UNKNOWN) {
+            double parsed = 0.0;
+            bool ok = parse(view(), parsed);
+            numeric_.store(ok ? parsed : 0.0, std::memory_order_relaxed);
+            state = ok ? NUMERIC_YES : NUMERIC_NO;
+            numericState_.store(state, std::memory_order_release);
+        }
+        out = numeric_.load(std::memory_order_relaxed);
+        return state == NUMERIC_YES;
+    }
+
+    // Hash shared by inline and heap strings; never 0 so 0 can mean "not cached"
+    static size_t hashChars(std::string_view s) {
+        size_t h = std::hash<std::string_view>()(s);
+        return h != 0 ? h : 1;
+    }
+
+private:
+    enum : uint8_t {
+        NUMERIC_UNKNOWN,
+        NUMERIC_YES,
+        NUMERIC_NO
+    };
+
+    mutable std::atomic<size_t> hash_{0};
+    mutable std::atomic<uint8_t> numericState_{NUMERIC_UNKNOWN};
+    mutable std::atomic<double> numeric_{0.0};   // published by numericState_
+    mutable std::atomic<const char*> data_{nullptr};
+    size_t capacity_ = 0;   // FLAT only
+    // CONCAT only, until flattened
+    mutable const StringRep* left_ = nullptr;
+    mutable const StringRep* right_ = nullptr;
+
+    StringRep(Kind k, size_t n) : size(n), kind(k) {}
+
+    static void destroy(const StringRep* rep) {
+        size_t bytes = sizeof(StringRep);
+        if (rep->kind == Kind::CONCAT) {
+            if (const char* d = rep->data_.load(std::memory_order_relaxed)) {
+                runtimeDeallocate(const_cast<char*>(d), rep->size + 1);
+            }
+        } else {
+            bytes += rep->capacity_ + 1;
+        }
+        rep->~StringRep();
+        runtimeDeallocate(const_cast<StringRep*>(rep), bytes);
+    }
+
+    // A rope node's children are read and swapped for its buffer under the
+    // node's stripe lock. Walkers hold one lock at a time and retain the
+    // children they read, so a concurrent flatten of a shared subtree never
+    // frees nodes still being copied, and flattens of unrelated ropes do not
+    // wait for each other.
+    static constexpr size_t kFlattenStripes = 64;
+
+    static std::mutex& flattenMutex(const StringRep* rep) {
+        static std::mutex stripes[kFlattenStripes];
+        return stripes[(reinterpret_cast<uintptr_t>(rep) >> 4) % kFlattenStripes];
+    }
+
+    // Buffer of a flattened node, or null after retaining its children
+    const char* bytesOrChildren(const StringRep*& left, const StringRep*& right) const {
+        std::lock_guard<std::mutex> lock(flattenMutex(this));
+        if (const char* d = data_.load(std::memory_order_acquire)) {
+            return d;
+        }
+        left = left_;
+        right = right_;
+        left->retain();
+        right->retain();
+        return nullptr;
+    }
+
+    const char* flatten() const {
+        const StringRep* left;
+        const StringRep* right;
+        if (const char* d = bytesOrChildren(left, right)) {
+            return d;
+        }
+
+        char* buffer = static_cast<char*>(runtimeAllocate(size + 1));
+        buffer[size] = '\0';
+
+        // Fill from the end, right child first: appends build left-deep
+        // chains, and this order keeps the work stack at two entries for them.
+        // Every node on the stack holds a reference taken for this walk.
+        size_t cursor = size;
+        std::vector<const StringRep*> stack{left, right};
+        while (!stack.empty()) {
+            const StringRep* node = stack.back();
+            stack.pop_back();
+            const StringRep* nodeLeft;
+            const StringRep* nodeRight;
+            if (const char* d = node->bytesOrChildren(nodeLeft, nodeRight)) {
+                cursor -= node->size;
+                std::memcpy(buffer + cursor, d, node->size);
+            } else {
+                stack.push_back(nodeLeft);
+                stack.push_back(nodeRight);
+            }
+            release(node);
+        }
+
+        // Another thread may have flattened this node meanwhile; keep its buffer
+        const char* published;
+        bool won;
+        {
+            std::lock_guard<std::mutex> lock(flattenMutex(this));
+            published = data_.load(std::memory_order_acquire);
+            won = !published;
+            if (won) {
+                left_ = nullptr;
+                right_ = nullptr;
+                data_.store(buffer, std::memory_order_release);
+                published = buffer;
+            }
+        }
+        // The walk dropped the references it took; drop the node's own
+        if (won) {
+            release(left);
+            release(right);
+        } else {
+            runtimeDeallocate(buffer, size + 1);
+        }
+        return published;
+    }
+};
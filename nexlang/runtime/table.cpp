@@ -0,0 +1,765 @@
+// Columnar table implementation
+#include "table.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include "float_ops.h"
+#include "simd_ops.h"
+
+// Same tolerance as Value::compare, so filters agree with the language's
+// own comparisons
+static constexpr double kEpsilon = 1e-10;
+
+static std::runtime_error tableError(const std::string& message) {
+    return std::runtime_error("Table: " + message);
+}
+
+// ================= DICTIONARY BUILDER =================
+
+// Interns strings into a StringDictionary. The index is an open-addressing
+// table of codes (compared through the dictionary itself), so no key is
+// stored twice and lookups need no allocation.
+class DictionaryBuilder {
+public:
+    DictionaryBuilder() : dictionary_(std::make_shared<StringDictionary>()), slots_(64, kEmpty) {}
+
+    uint32_t intern(std::string_view text) {
+        size_t hash = std::hash<std::string_view>()(text);
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            uint32_t code = slots_[slot];
+            if (code == kEmpty) {
+                code = add(text, hash);
+                slots_[slot] = code;
+                if (hashes_.size() * 2 > slots_.size()) {
+                    grow();
+                }
+                return code;
+            }
+            if (hashes_[code] == hash && dictionary_->at(code) == text) {
+                return code;
+            }
+        }
+    }
+
+    std::shared_ptr<const StringDictionary> finish() { return dictionary_; }
+
+private:
+    static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+    std::shared_ptr<StringDictionary> dictionary_;
+    std::vector<uint32_t> slots_;   // power-of-two size, at most half full
+    std::vector<size_t> hashes_;    // by code
+
+    uint32_t add(std::string_view text, size_t hash) {
+        StringDictionary& dictionary = *dictionary_;
+        if (dictionary.chars.size() + text.size() > std::numeric_limits<uint32_t>::max()) {
+            throw tableError("string column exceeds 4 GiB");
+        }
+        dictionary.chars.append(text.data(), text.size());
+        dictionary.offsets.push_back(static_cast<uint32_t>(dictionary.chars.size()));
+        hashes_.push_back(hash);
+        return static_cast<uint32_t>(hashes_.size() - 1);
+    }
+
+    void grow() {
+        std::vector<uint32_t> slots(slots_.size() * 2, kEmpty);
+        size_t mask = slots.size() - 1;
+        for (uint32_t code = 0; code < hashes_.size(); ++code) {
+            size_t slot = hashes_[code] & mask;
+            while (slots[slot] != kEmpty) slot = (slot + 1) & mask;
+            slots[slot] = code;
+        }
+        slots_.swap(slots);
+    }
+};
+
+// ================= COLUMN BUILDER =================
+
+// Appends rows to a new column. Null rows hold NaN (FLOAT) or the code of
+// "" (STRING), so readers that ignore the bitmap still see a neutral value.
+class ColumnBuilder {
+public:
+    explicit ColumnBuilder(Column::Type type) : column_(std::make_shared<Column>()) {
+        column_->type = type;
+        if (type == Column::Type::STRING) {
+            dictionary_ = std::make_unique<DictionaryBuilder>();
+        }
+    }
+
+    void reserve(size_t rows) {
+        if (column_->type == Column::Type::FLOAT) {
+            column_->numbers.reserve(rows);
+        } else {
+            column_->codes.reserve(rows);
+        }
+        column_->validity.reserve((rows + 63) / 64);
+    }
+
+    void appendNumber(double value) {
+        column_->numbers.push_back(value);
+        markRow(true);
+    }
+
+    void appendString(std::string_view text) {
+        column_->codes.push_back(dictionary_->intern(text));
+        markRow(true);
+    }
+
+    void appendNull() {
+        if (column_->type == Column::Type::FLOAT) {
+            column_->numbers.push_back(std::numeric_limits<double>::quiet_NaN());
+        } else {
+            column_->codes.push_back(dictionary_->intern(std::string_view()));
+        }
+        anyNull_ = true;
+        markRow(false);
+    }
+
+    std::shared_ptr<const Column> finish() {
+        if (!anyNull_) {
+            column_->validity.clear();
+            column_->validity.shrink_to_fit();
+        }
+        if (dictionary_) {
+            column_->dictionary = dictionary_->finish();
+        }
+        return column_;
+    }
+
+private:
+    std::shared_ptr<Column> column_;
+    std::unique_ptr<DictionaryBuilder> dictionary_;
+    size_t rows_ = 0;
+    bool anyNull_ = false;
+
+    // The bitmap is kept while building and dropped if no row is null
+    void markRow(bool valid) {
+        if ((rows_ & 63) == 0) {
+            column_->validity.push_back(0);
+        }
+        if (valid) {
+            column_->validity.back() |= uint64_t(1) << (rows_ & 63);
+        }
+        ++rows_;
+    }
+};
+
+// ================= TABLE REP =================
+
+int TableRep::findColumn(std::string_view name) const {
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+const Column& TableRep::column(std::string_view name) const {
+    int index = findColumn(name);
+    if (index < 0) {
+        throw tableError("unknown column '" + std::string(name) + "'");
+    }
+    return *columns[index];
+}
+
+static void appendCsvField(std::string& out, std::string_view field) {
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(field.data(), field.size());
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+std::string TableRep::toString() const {
+    std::string text;
+    for (size_t c = 0; c < names.size(); ++c) {
+        if (c > 0) text += ',';
+        appendCsvField(text, names[c]);
+    }
+    text += '\n';
+    char buffer[kFloatBufferSize];
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t c = 0; c < columns.size(); ++c) {
+            if (c > 0) text += ',';
+            const Column& column = *columns[c];
+            if (column.isNull(row)) {
+                continue;
+            }
+            if (column.type == Column::Type::FLOAT) {
+                text.append(buffer, formatFloat(column.numbers[row], buffer, sizeof(buffer)));
+            } else {
+                appendCsvField(text, column.stringAt(row));
+            }
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+// ================= PARSING OPERATORS =================
+
+FilterOp parseFilterOp(std::string_view text) {
+    if (text == "=" || text == "==") return FilterOp::EQUAL;
+    if (text == "!=") return FilterOp::NOT_EQUAL;
+    if (text == "<") return FilterOp::LESS;
+    if (text == "<=") return FilterOp::LESS_EQUAL;
+    if (text == ">") return FilterOp::GREATER;
+    if (text == ">=") return FilterOp::GREATER_EQUAL;
+    throw tableError("unknown comparison '" + std::string(text) + "'");
+}
+
+AggregateOp parseAggregateOp(std::string_view text) {
+    if (text == "count") return AggregateOp::COUNT;
+    if (text == "sum") return AggregateOp::SUM;
+    if (text == "min") return AggregateOp::MIN;
+    if (text == "max") return AggregateOp::MAX;
+    if (text == "avg") return AggregateOp::AVG;
+    throw tableError("unknown aggregate '" + std::string(text) + "'");
+}
+
+static const char* aggregateName(AggregateOp op) {
+    switch (op) {
+        case AggregateOp::COUNT: return "count";
+        case AggregateOp::SUM:   return "sum";
+        case AggregateOp::MIN:   return "min";
+        case AggregateOp::MAX:   return "max";
+        case AggregateOp::AVG:   return "avg";
+    }
+    return "?";
+}
+
+// ================= BUILDING TABLES =================
+
+TableRep* tableFromArrays(const std::vector<std::string>& names, const std::vector<const ArrayRep*>& arrays) {
+    std::unique_ptr<TableRep> table = std::make_unique<TableRep>();
+    table->rows = arrays.empty() ? 0 : arrays[0]->size();
+    for (size_t c = 0; c < arrays.size(); ++c) {
+        const ArrayRep& array = *arrays[c];
+        if (array.size() != table->rows) {
+            throw tableError("column '" + names[c] + "' has a different length");
+        }
+        if (array.layout() == ArrayRep::Layout::FLOAT) {
+            std::shared_ptr<Column> column = std::make_shared<Column>();
+            column->numbers.assign(array.floatData(), array.floatData() + array.size());
+            table->columns.push_back(std::move(column));
+        } else {
+            ColumnBuilder builder(Column::Type::STRING);
+            builder.reserve(array.size());
+            for (size_t row = 0; row < array.size(); ++row) {
+                builder.appendString(array.stringAt(row));
+            }
+            table->columns.push_back(builder.finish());
+        }
+        table->names.push_back(names[c]);
+    }
+    return table.release();
+}
+
+// ================= CSV =================
+
+// Splits CSV text into records. Fields are views into the text, or into
+// per-field scratch strings when quotes had to be unescaped.
+class CsvReader {
+public:
+    explicit CsvReader(std::string_view text) : text_(text) {}
+
+    // Next non-blank record; false at the end of the text
+    bool next(std::vector<std::string_view>& fields) {
+        fields.clear();
+        while (pos_ < text_.size() && (text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+        ++record_;
+        for (;;) {
+            fields.push_back(field(fields.size()));
+            if (pos_ >= text_.size()) {
+                return true;
+            }
+            char c = text_[pos_++];
+            if (c == '\n') {
+                return true;
+            }
+            if (c == '\r') {
+                if (pos_ < text_.size() && text_[pos_] == '\n') ++pos_;
+                return true;
+            }
+            // c == ','; on to the next field
+        }
+    }
+
+    size_t record() const { return record_; }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+    size_t record_ = 0;
+    // A deque, so growing it for a later field leaves the views of earlier
+    // fields in the record (into short, inline strings) valid
+    std::deque<std::string> scratch_;
+
+    // Reads one field and stops at the delimiter or line end after it
+    std::string_view field(size_t index) {
+        size_t start = pos_;
+        if (pos_ >= text_.size() || text_[pos_] != '"') {
+            while (pos_ < text_.size()) {
+                char c = text_[pos_];
+                if (c == ',' || c == '\n' || c == '\r') break;
+                ++pos_;
+            }
+            return text_.substr(start, pos_ - start);
+        }
+
+        // Quoted: a view if there is no "" escape, else unescaped to scratch
+        ++pos_;
+        size_t contentStart = pos_;
+        bool escaped = false;
+        for (;;) {
+            size_t quote = text_.find('"', pos_);
+            if (quote == std::string_view::npos) {
+                throw tableError("unterminated quote in CSV record " + std::to_string(record_));
+            }
+            if (quote + 1 < text_.size() && text_[quote + 1] == '"') {
+                escaped = true;
+                pos_ = quote + 2;
+                continue;
+            }
+            pos_ = quote + 1;
+            break;
+        }
+        if (pos_ < text_.size() && text_[pos_] != ',' && text_[pos_] != '\n' && text_[pos_] != '\r') {
+            throw tableError("text after a closing quote in CSV record " + std::to_string(record_));
+        }
+        std::string_view content = text_.substr(contentStart, pos_ - 1 - contentStart);
+        if (!escaped) {
+            return content;
+        }
+        if (scratch_.size() <= index) {
+            scratch_.resize(index + 1);
+        }
+        std::string& out = scratch_[index];
+        out.clear();
+        for (size_t i = 0; i < content.size(); ++i) {
+            out += content[i];
+            if (content[i] == '"') ++i;   // skip the second quote of ""
+        }
+        return out;
+    }
+};
+
+// Two passes over the text: the first settles each column's type, the
+// second builds the columns, so no per-cell data is held in between
+TableRep* tableFromCsv(std::string_view text) {
+    std::vector<std::string_view> fields;
+    CsvReader header(text);
+    std::unique_ptr<TableRep> table = std::make_unique<TableRep>();
+    if (!header.next(fields)) {
+        return table.release();
+    }
+    for (std::string_view name : fields) {
+        table->names.emplace_back(name);
+    }
+    size_t columnCount = table->names.size();
+
+    std::vector<bool> numeric(columnCount, true);
+    size_t rows = 0;
+    while (header.next(fields)) {
+        if (fields.size() > columnCount) {
+            throw tableError("CSV record " + std::to_string(header.record()) + " has more fields than the header");
+        }
+        for (size_t c = 0; c < fields.size(); ++c) {
+            if (numeric[c] && !fields[c].empty() && !parseFloat(fields[c])) {
+                numeric[c] = false;
+            }
+        }
+        ++rows;
+    }
+
+    std::vector<ColumnBuilder> builders;
+    builders.reserve(columnCount);
+    for (size_t c = 0; c < columnCount; ++c) {
+        builders.emplace_back(numeric[c] ? Column::Type::FLOAT : Column::Type::STRING);
+        builders.back().reserve(rows);
+    }
+    CsvReader reader(text);
+    reader.next(fields);   // header
+    while (reader.next(fields)) {
+        for (size_t c = 0; c < columnCount; ++c) {
+            if (c >= fields.size() || fields[c].empty()) {
+                builders[c].appendNull();
+            } else if (numeric[c]) {
+                builders[c].appendNumber(*parseFloat(fields[c]));
+            } else {
+                builders[c].appendString(fields[c]);
+            }
+        }
+    }
+    table->rows = rows;
+    for (ColumnBuilder& builder : builders) {
+        table->columns.push_back(builder.finish());
+    }
+    return table.release();
+}
+
+// ================= PROJECTION =================
+
+TableRep* selectColumns(const TableRep& table, const std::vector<std::string_view>& names) {
+    std::unique_ptr<TableRep> result = std::make_unique<TableRep>();
+    result->rows = table.rows;
+    for (std::string_view name : names) {
+        int index = table.findColumn(name);
+        if (index < 0) {
+            throw tableError("unknown column '" + std::string(name) + "'");
+        }
+        result->names.push_back(table.names[index]);
+        result->columns.push_back(table.columns[index]);
+    }
+    return result.release();
+}
+
+// ================= FILTER =================
+// Filters produce a selection vector (the indices of the passing rows) in
+// one branch-free pass: every row index is written and the count only
+// advances when the row passes. The columns are then gathered through it.
+
+template <typename Pass>
+static void selectRows(const Column& column, size_t rows, Pass pass, std::vector<size_t>& selection) {
+    selection.resize(rows);
+    size_t* out = selection.data();
+    size_t count = 0;
+    if (!column.hasNulls()) {
+        for (size_t row = 0; row < rows; ++row) {
+            out[count] = row;
+            count += pass(row) ? 1 : 0;
+        }
+    } else {
+        const uint64_t* valid = column.validity.data();
+        for (size_t row = 0; row < rows; ++row) {
+            out[count] = row;
+            count += (pass(row) ? 1 : 0) & ((valid[row >> 6] >> (row & 63)) & 1);
+        }
+    }
+    selection.resize(count);
+}
+
+static void selectNumbers(const Column& column, size_t rows, FilterOp op, double x, std::vector<size_t>& selection) {
+    const double* v = column.numbers.data();
+    switch (op) {
+        case FilterOp::EQUAL:
+            selectRows(column, rows, [=](size_t i) { return std::abs(v[i] - x) < kEpsilon; }, selection);
+            break;
+        case FilterOp::NOT_EQUAL:
+            selectRows(column, rows, [=](size_t i) { return !(std::abs(v[i] - x) < kEpsilon); }, selection);
+            break;
+        case FilterOp::LESS:
+            selectRows(column, rows, [=](size_t i) { return v[i] < x && !(std::abs(v[i] - x) < kEpsilon); }, selection);
+            break;
+        case FilterOp::LESS_EQUAL:
+            selectRows(column, rows, [=](size_t i) { return v[i] < x || std::abs(v[i] - x) < kEpsilon; }, selection);
+            break;
+        case FilterOp::GREATER:
+            selectRows(column, rows, [=](size_t i) { return v[i] > x && !(std::abs(v[i] - x) < kEpsilon); }, selection);
+            break;
+        case FilterOp::GREATER_EQUAL:
+            selectRows(column, rows, [=](size_t i) { return v[i] > x || std::abs(v[i] - x) < kEpsilon; }, selection);
+            break;
+    }
+}
+
+static bool compareText(std::string_view lhs, FilterOp op, std::string_view rhs) {
+    int order = lhs.compare(rhs);
+    switch (op) {
+        case FilterOp::EQUAL:         return order == 0;
+        case FilterOp::NOT_EQUAL:     return order != 0;
+        case FilterOp::LESS:          return order < 0;
+        case FilterOp::LESS_EQUAL:    return order <= 0;
+        case FilterOp::GREATER:       return order > 0;
+        case FilterOp::GREATER_EQUAL: return order >= 0;
+    }
+    return false;
+}
+
+// The predicate is evaluated once per dictionary entry; rows only look up
+// their code
+static void selectStrings(const Column& column, size_t rows, FilterOp op, std::string_view text,
+                          std::vector<size_t>& selection) {
+    const StringDictionary& dictionary = *column.dictionary;
+    std::vector<uint8_t> passes(dictionary.size());
+    for (uint32_t code = 0; code < passes.size(); ++code) {
+        passes[code] = compareText(dictionary.at(code), op, text) ? 1 : 0;
+    }
+    const uint8_t* pass = passes.data();
+    const uint32_t* codes = column.codes.data();
+    selectRows(column, rows, [=](size_t i) { return pass[codes[i]] != 0; }, selection);
+}
+
+static std::shared_ptr<const Column> gatherColumn(const Column& source, const std::vector<size_t>& selection) {
+    std::shared_ptr<Column> column = std::make_shared<Column>();
+    column->type = source.type;
+    size_t n = selection.size();
+    if (source.type == Column::Type::FLOAT) {
+        column->numbers.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            column->numbers[i] = source.numbers[selection[i]];
+        }
+    } else {
+        column->codes.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            column->codes[i] = source.codes[selection[i]];
+        }
+        column->dictionary = source.dictionary;
+    }
+    if (source.hasNulls()) {
+        bool anyNull = false;
+        column->validity.assign((n + 63) / 64, 0);
+        for (size_t i = 0; i < n; ++i) {
+            if (source.isNull(selection[i])) {
+                anyNull = true;
+            } else {
+                column->validity[i >> 6] |= uint64_t(1) << (i & 63);
+            }
+        }
+        if (!anyNull) {
+            column->validity.clear();
+        }
+    }
+    return column;
+}
+
+TableRep* filterRows(const TableRep& table, std::string_view name, FilterOp op, const FilterOperand& operand) {
+    const Column& column = table.column(name);
+    std::vector<size_t> selection;
+    if (column.type == Column::Type::FLOAT) {
+        if (!operand.isNumber) {
+            throw tableError("column '" + std::string(name) + "' is numeric; cannot compare it with '" +
+                             std::string(operand.text) + "'");
+        }
+        selectNumbers(column, table.rows, op, operand.number, selection);
+    } else {
+        selectStrings(column, table.rows, op, operand.text, selection);
+    }
+
+    std::unique_ptr<TableRep> result = std::make_unique<TableRep>();
+    result->rows = selection.size();
+    result->names = table.names;
+    if (selection.size() == table.rows) {
+        result->columns = table.columns;
+    } else {
+        for (const std::shared_ptr<const Column>& source : table.columns) {
+            result->columns.push_back(gatherColumn(*source, selection));
+        }
+    }
+    return result.release();
+}
+
+// ================= AGGREGATION =================
+
+static size_t validCount(const Column& column, size_t rows) {
+    if (!column.hasNulls()) {
+        return rows;
+    }
+    size_t count = 0;
+    for (uint64_t word : column.validity) {
+        count += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return count;
+}
+
+static AggregateResult numberResult(double number) {
+    AggregateResult result;
+    result.kind = AggregateResult::Kind::NUMBER;
+    result.number = number;
+    return result;
+}
+
+AggregateResult aggregateColumn(const TableRep& table, std::string_view name, AggregateOp op) {
+    const Column& column = table.column(name);
+    size_t rows = table.rows;
+    size_t count = validCount(column, rows);
+    if (op == AggregateOp::COUNT) {
+        return numberResult(static_cast<double>(count));
+    }
+
+    if (column.type == Column::Type::STRING) {
+        if (op != AggregateOp::MIN && op != AggregateOp::MAX) {
+            throw tableError(std::string("cannot ") + aggregateName(op) + " string column '" + std::string(name) + "'");
+        }
+        // Extremes among the dictionary entries some non-null row uses
+        std::vector<uint8_t> used(column.dictionary->size(), 0);
+        for (size_t row = 0; row < rows; ++row) {
+            if (!column.isNull(row)) used[column.codes[row]] = 1;
+        }
+        AggregateResult result;
+        for (uint32_t code = 0; code < used.size(); ++code) {
+            if (!used[code]) continue;
+            std::string_view text = column.dictionary->at(code);
+            if (result.kind == AggregateResult::Kind::NONE ||
+                (op == AggregateOp::MIN ? text < result.text : text > result.text)) {
+                result.kind = AggregateResult::Kind::TEXT;
+                result.text = text;
+            }
+        }
+        return result;
+    }
+
+    if (count == 0) {
+        return op == AggregateOp::SUM ? numberResult(0.0) : AggregateResult();
+    }
+    const double* v = column.numbers.data();
+    if (!column.hasNulls()) {
+        const SimdKernels& kernels = simdKernels();
+        switch (op) {
+            case AggregateOp::SUM: return numberResult(kernels.sum(v, rows));
+            case AggregateOp::MIN: return numberResult(kernels.min(v, rows));
+            case AggregateOp::MAX: return numberResult(kernels.max(v, rows));
+            case AggregateOp::AVG: return numberResult(kernels.sum(v, rows) / static_cast<double>(rows));
+            case AggregateOp::COUNT: break;
+        }
+    }
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    for (size_t row = 0; row < rows; ++row) {
+        if (column.isNull(row)) continue;
+        sum += v[row];
+        min = std::min(min, v[row]);
+        max = std::max(max, v[row]);
+    }
+    switch (op) {
+        case AggregateOp::SUM: return numberResult(sum);
+        case AggregateOp::MIN: return numberResult(min);
+        case AggregateOp::MAX: return numberResult(max);
+        case AggregateOp::AVG: return numberResult(sum / static_cast<double>(count));
+        case AggregateOp::COUNT: break;
+    }
+    return AggregateResult();
+}
+
+// ================= GROUP BY =================
+
+// Group of every row, numbered in order of first appearance; firstRows
+// gets each group's first row
+static std::vector<uint32_t> assignGroups(const Column& key, size_t rows, std::vector<size_t>& firstRows) {
+    std::vector<uint32_t> groups(rows);
+    constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+    uint32_t nullGroup = kNone;
+    auto groupFor = [&](uint32_t& slot, size_t row) {
+        if (slot == kNone) {
+            slot = static_cast<uint32_t>(firstRows.size());
+            firstRows.push_back(row);
+        }
+        return slot;
+    };
+
+    if (key.type == Column::Type::STRING) {
+        // Codes index the groups directly
+        std::vector<uint32_t> groupOfCode(key.dictionary->size(), kNone);
+        for (size_t row = 0; row < rows; ++row) {
+            groups[row] = key.isNull(row) ? groupFor(nullGroup, row) : groupFor(groupOfCode[key.codes[row]], row);
+        }
+    } else {
+        std::unordered_map<uint64_t, uint32_t> groupOfKey;
+        for (size_t row = 0; row < rows; ++row) {
+            if (key.isNull(row)) {
+                groups[row] = groupFor(nullGroup, row);
+                continue;
+            }
+            double value = key.numbers[row] == 0.0 ? 0.0 : key.numbers[row];   // -0 groups with 0
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            auto inserted = groupOfKey.emplace(bits, kNone);
+            groups[row] = groupFor(inserted.first->second, row);
+        }
+    }
+    return groups;
+}
+
+TableRep* groupRows(const TableRep& table, std::string_view keyName, std::string_view name, AggregateOp op) {
+    const Column& key = table.column(keyName);
+    const Column& column = table.column(name);
+    if (column.type == Column::Type::STRING && op != AggregateOp::COUNT) {
+        throw tableError(std::string("cannot ") + aggregateName(op) + " string column '" + std::string(name) +
+                         "' by group");
+    }
+
+    size_t rows = table.rows;
+    std::vector<size_t> firstRows;
+    std::vector<uint32_t> groups = assignGroups(key, rows, firstRows);
+    size_t groupCount = firstRows.size();
+
+    std::vector<size_t> counts(groupCount, 0);
+    std::vector<double> values(groupCount, op == AggregateOp::MIN   ? std::numeric_limits<double>::infinity()
+                                           : op == AggregateOp::MAX ? -std::numeric_limits<double>::infinity()
+                                                                    : 0.0);
+    for (size_t row = 0; row < rows; ++row) {
+        if (column.isNull(row)) continue;
+        uint32_t group = groups[row];
+        ++counts[group];
+        if (op == AggregateOp::COUNT) continue;
+        double v = column.numbers[row];
+        double& acc = values[group];
+        acc = op == AggregateOp::MIN ? std::min(acc, v) : op == AggregateOp::MAX ? std::max(acc, v) : acc + v;
+    }
+
+    ColumnBuilder keys(key.type);
+    ColumnBuilder results(Column::Type::FLOAT);
+    keys.reserve(groupCount);
+    results.reserve(groupCount);
+    for (size_t group = 0; group < groupCount; ++group) {
+        size_t row = firstRows[group];
+        if (key.isNull(row)) {
+            keys.appendNull();
+        } else if (key.type == Column::Type::FLOAT) {
+            keys.appendNumber(key.numbers[row]);
+        } else {
+            keys.appendString(key.stringAt(row));
+        }
+
+        if (op == AggregateOp::COUNT) {
+            results.appendNumber(static_cast<double>(counts[group]));
+        } else if (op == AggregateOp::SUM) {
+            results.appendNumber(values[group]);
+        } else if (counts[group] == 0) {
+            results.appendNull();
+        } else if (op == AggregateOp::AVG) {
+            results.appendNumber(values[group] / static_cast<double>(counts[group]));
+        } else {
+            results.appendNumber(values[group]);
+        }
+    }
+
+    std::unique_ptr<TableRep> result = std::make_unique<TableRep>();
+    result->rows = groupCount;
+    result->names.push_back(std::string(keyName));
+    result->names.push_back(std::string(aggregateName(op)) + "(" + std::string(name) + ")");
+    result->columns.push_back(keys.finish());
+    result->columns.push_back(results.finish());
+    return result.release();
+}
+
+// ================= CONVERSION =================
+
+ArrayRep* columnToArray(const Column& column) {
+    std::unique_ptr<ArrayRep> array = std::make_unique<ArrayRep>();
+    if (column.type == Column::Type::FLOAT) {
+        array->floatStorage() = column.numbers;
+        return array.release();
+    }
+    array->reserve(column.size());
+    for (size_t row = 0; row < column.size(); ++row) {
+        array->appendString(column.stringAt(row));
+    }
+    return array.release();
+}
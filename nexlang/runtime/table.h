@@ -0,0 +1,147 @@
+// Header for columnar tables
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "array.h"
+
+// ================= STRING DICTIONARY =================
+// Distinct strings of a column, each stored once. Rows hold a 32-bit code
+// into the dictionary, so comparisons and grouping work on integers and a
+// predicate is evaluated once per distinct string, not once per row.
+struct StringDictionary {
+    std::string chars;
+    std::vector<uint32_t> offsets{0};   // size() + 1 entries
+
+    size_t size() const { return offsets.size() - 1; }
+
+    std::string_view at(uint32_t code) const {
+        return std::string_view(chars.data() + offsets[code], offsets[code + 1] - offsets[code]);
+    }
+};
+
+// ================= COLUMN =================
+// One typed column vector. Columns are immutable once built and shared
+// between tables, so selecting columns never copies data.
+struct Column {
+    enum class Type : uint8_t {
+        FLOAT,
+        STRING   // dictionary codes
+    };
+
+    Type type = Type::FLOAT;
+    std::vector<double> numbers;                            // FLOAT
+    std::vector<uint32_t> codes;                            // STRING
+    std::shared_ptr<const StringDictionary> dictionary;     // STRING
+    // Bit i set if row i has a value; empty when the column has no nulls.
+    // Null rows hold NaN (FLOAT) or the code of "" (STRING).
+    std::vector<uint64_t> validity;
+
+    size_t size() const { return type == Type::FLOAT ? numbers.size() : codes.size(); }
+
+    bool hasNulls() const { return !validity.empty(); }
+
+    bool isNull(size_t row) const {
+        return hasNulls() && !((validity[row >> 6] >> (row & 63)) & 1);
+    }
+
+    std::string_view stringAt(size_t row) const { return dictionary->at(codes[row]); }
+};
+
+// ================= TABLE REP =================
+// Refcounted payload of a TABLE Value: named columns of equal length.
+// Like arrays, tables are immutable once wrapped in a Value; operations
+// build new tables that share whatever columns they leave unchanged.
+struct TableRep {
+    mutable std::atomic<uint32_t> refCount{1};
+
+    size_t rows = 0;
+    std::vector<std::string> names;
+    std::vector<std::shared_ptr<const Column>> columns;
+
+    // Index of the named column, or -1
+    int findColumn(std::string_view name) const;
+
+    // Throws std::runtime_error for an unknown name
+    const Column& column(std::string_view name) const;
+
+    // CSV text: a header line, then one line per row; nulls are empty
+    std::string toString() const;
+};
+
+// ================= TABLE OPERATIONS =================
+// Errors (unknown columns, mismatched lengths, malformed CSV, operations a
+// column type does not support) throw std::runtime_error. The returned
+// TableRep carries one reference for the caller.
+
+enum class FilterOp {
+    EQUAL,
+    NOT_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL
+};
+
+enum class AggregateOp {
+    COUNT,   // non-null values
+    SUM,
+    MIN,
+    MAX,
+    AVG
+};
+
+// "=" "==" "!=" "<" "<=" ">" ">="
+FilterOp parseFilterOp(std::string_view text);
+// "count" "sum" "min" "max" "avg"
+AggregateOp parseAggregateOp(std::string_view text);
+
+// Comparison operand of a filter: FLOAT columns compare with number (a
+// non-numeric operand is an error), STRING columns with text (byte order)
+struct FilterOperand {
+    std::string_view text;
+    bool isNumber;
+    double number;
+};
+
+// Table from equal-length arrays: FLOAT arrays become FLOAT columns,
+// STRING arrays dictionary-encoded STRING columns
+TableRep* tableFromArrays(const std::vector<std::string>& names, const std::vector<const ArrayRep*>& arrays);
+
+// First line is the header. Fields may be quoted ("a, ""b""") and lines end
+// in LF or CRLF. A column whose non-empty fields are all numbers is FLOAT,
+// otherwise STRING; empty fields are nulls, as are missing trailing fields.
+TableRep* tableFromCsv(std::string_view text);
+
+// The named columns, in the order given (no data is copied)
+TableRep* selectColumns(const TableRep& table, const std::vector<std::string_view>& names);
+
+// Rows whose value in column satisfies op operand; nulls never do
+TableRep* filterRows(const TableRep& table, std::string_view column, FilterOp op, const FilterOperand& operand);
+
+// Result of aggregating one column; NONE when there is nothing to report
+// (MIN/MAX/AVG over no values)
+struct AggregateResult {
+    enum class Kind : uint8_t {
+        NONE,
+        NUMBER,
+        TEXT
+    };
+    Kind kind = Kind::NONE;
+    double number = 0.0;
+    std::string_view text;   // MIN/MAX of a STRING column; points into the table
+};
+
+// STRING columns support COUNT, MIN and MAX
+AggregateResult aggregateColumn(const TableRep& table, std::string_view column, AggregateOp op);
+
+// One row per distinct key (nulls form one group), in order of first
+// appearance, with columns key and "op(column)"
+TableRep* groupRows(const TableRep& table, std::string_view key, std::string_view column, AggregateOp op);
+
+// Column as an array: FLOAT nulls read as NaN, STRING nulls as ""
+ArrayRep* columnToArray(const Column& column);
@@ -0,0 +1,109 @@
+// Runtime thread pool implementation
+#include "thread_pool.h"
+#include <cstdlib>
+
+ThreadPool& ThreadPool::getInstance() {
+    static ThreadPool instance;
+    return instance;
+}
+
+// NEXLANG_THREADS if it is a usable count, otherwise the hardware threads
+static size_t threadCount() {
+    if (const char* text = std::getenv("NEXLANG_THREADS")) {
+        char* end = nullptr;
+        unsigned long count = std::strtoul(text, &end, 10);
+        if (end != text && *end == '\0' && count >= 1 && count <= ThreadPool::kMaxThreads) {
+            return count;
+        }
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+ThreadPool::ThreadPool() {
+    size_t workers = threadCount() - 1;
+    workers_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    auto batch = std::make_shared<Batch>();
+    batch->task = &task;
+    batch->count = count;
+    if (count > 1 && !workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(batch);
+        }
+        wake_.notify_all();
+    }
+
+    drain(*batch);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [&] { return batch->finished.load(std::memory_order_acquire) == count; });
+    }
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+void ThreadPool::drain(Batch& batch) {
+    for (;;) {
+        size_t index = batch.next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= batch.count) {
+            return;
+        }
+        try {
+            (*batch.task)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(batch.errorMutex);
+            if (!batch.error) {
+                batch.error = std::current_exception();
+            }
+        }
+        if (batch.finished.fetch_add(1, std::memory_order_acq_rel) + 1 == batch.count) {
+            // Lock so the notification cannot slip in between the waiter's
+            // check and its wait
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        // Batches whose tasks have all been handed out are done with the queue
+        while (!queue_.empty() && queue_.front()->next.load(std::memory_order_relaxed) >= queue_.front()->count) {
+            queue_.pop_front();
+        }
+        if (queue_.empty()) {
+            if (stopping_) {
+                return;
+            }
+            wake_.wait(lock);
+            continue;
+        }
+        std::shared_ptr<Batch> batch = queue_.front();
+        lock.unlock();
+        drain(*batch);
+        lock.lock();
+    }
+}
@@ -0,0 +1,62 @@
+// Header for the runtime thread pool
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ================= THREAD POOL =================
+// Process-wide workers for data-parallel builtins (parallel sorts). Work
+// is submitted as a batch of numbered tasks; the caller helps run its own
+// batch and returns once every task has finished, so a task may itself
+// call run() without deadlocking the pool.
+//
+// The pool has one thread per hardware thread, counting the caller. The
+// NEXLANG_THREADS environment variable overrides that count (1 means no
+// workers); it is read once, when the pool is first used.
+class ThreadPool {
+public:
+    static constexpr size_t kMaxThreads = 256;
+
+    static ThreadPool& getInstance();
+
+    // Threads that can work on one batch: the workers plus the caller
+    size_t concurrency() const { return workers_.size() + 1; }
+
+    // Calls task(0) .. task(count - 1) and waits for all of them. If tasks
+    // throw, the first exception is rethrown here after the batch is done.
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    struct Batch {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        std::atomic<size_t> next{0};       // next task index to hand out
+        std::atomic<size_t> finished{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;       // a batch was queued, or stopping
+    std::condition_variable finished_;   // a batch's last task finished
+    std::deque<std::shared_ptr<Batch>> queue_;
+    bool stopping_ = false;
+
+    ThreadPool();
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void workerLoop();
+    // Runs tasks of batch until none are left to hand out
+    void drain(Batch& batch);
+};
@@ -1,62 +1,255 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <memory>
-#include <variant>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <utility>
 #include <stdexcept>
 #include <cmath>
+#include "string_rep.h"
+#include "float_ops.h"
+#include "array.h"
+#include "table.h"
+#include "handle_table.h"
 
 using namespace std;
 
 // ================= VALUE TYPES =================
-enum class ValueType {
+enum class ValueType : uint8_t {
     STRING,
     FLOAT,
     BOOL,
-    HANDLE
+    HANDLE,
+    ARRAY,
+    TABLE
 };
 
-// Forward declaration for handle type
-struct Handle {
-    std::string type;      // e.g., "file", "block", "socket"
-    void* ptr;             // pointer to the actual resource
-    int id;                // unique identifier
-    
-    Handle(std::string t, void* p, int i) : type(t), ptr(p), id(i) {}
-};
+// ================= HEAP PAYLOADS =================
+// Long STRING payloads (StringRep, see string_rep.h), ARRAY payloads
+// (ArrayRep, see array.h) and TABLE payloads (TableRep, see table.h) live in
+// refcounted heap objects, so copying a Value never deep-copies. HANDLE payloads are plain ids into the HandleTable
+// (see handle_table.h) and are stored inline.
+
+template <typename T>
+inline T* retainRef(T* obj) {
+    if (obj) {
+        obj->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return obj;
+}
+
+template <typename T>
+inline void releaseRef(T* obj) {
+    if (obj && obj->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete obj;
+    }
+}
 
-// Value object that represents all possible runtime values
+// Value object that represents all possible runtime values.
+// Layout (16 bytes): 15 payload bytes + 1 tag byte. FLOAT and BOOL are stored
+// inline; strings of up to 15 bytes are stored inline too. Longer strings
+// point to an immutable refcounted StringRep.
 class Value {
 public:
-    Value() : type_(ValueType::STRING), data_(std::string("")) {}
-    
-    explicit Value(const std::string& s) : type_(ValueType::STRING), data_(s) {}
-    explicit Value(double f) : type_(ValueType::FLOAT), data_(f) {}
-    explicit Value(bool b) : type_(ValueType::BOOL), data_(b) {}
-    explicit Value(Handle h) : type_(ValueType::HANDLE), data_(h) {}
-    
+    static constexpr size_t kInlineCapacity = 15;
+    // Concatenations longer than this build a rope node instead of copying
+    static constexpr size_t kRopeThreshold = 256;
+
+    Value() {
+        setSmallString(std::string_view());
+    }
+
+    explicit Value(std::string_view s) {
+        setString(s, std::string_view());
+    }
+    explicit Value(const std::string& s) : Value(std::string_view(s)) {}
+    explicit Value(const char* s) : Value(std::string_view(s)) {}
+    explicit Value(double f) {
+        setTag(REPR_FLOAT);
+        storeWord(f);
+    }
+    explicit Value(bool b) {
+        setTag(REPR_BOOL);
+        storeWord(b);
+    }
+    explicit Value(Handle h) {
+        static_assert(sizeof(Handle) <= kInlineCapacity, "a Handle is stored inline");
+        setTag(REPR_HANDLE);
+        storeWord(h);
+    }
+    // Takes over the caller's reference to array
+    explicit Value(ArrayRep* array) {
+        setTag(REPR_ARRAY);
+        storeWord(array);
+    }
+    // Takes over the caller's reference to table
+    explicit Value(TableRep* table) {
+        setTag(REPR_TABLE);
+        storeWord(table);
+    }
+
+    Value(const Value& other) {
+        copyFrom(other);
+    }
+
+    Value(Value&& other) noexcept {
+        stealFrom(other);
+    }
+
+    Value& operator=(const Value& other) {
+        if (this != &other) {
+            releasePayload();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    Value& operator=(Value&& other) noexcept {
+        if (this != &other) {
+            releasePayload();
+            stealFrom(other);
+        }
+        return *this;
+    }
+
+    ~Value() {
+        releasePayload();
+    }
+
     // Type getters
-    ValueType getType() const { return type_; }
-    
-    const std::string& getString() const { 
-        return std::get<std::string>(data_); 
+    ValueType getType() const {
+        switch (repr()) {
+            case REPR_FLOAT:  return ValueType::FLOAT;
+            case REPR_BOOL:   return ValueType::BOOL;
+            case REPR_HANDLE: return ValueType::HANDLE;
+            case REPR_ARRAY:  return ValueType::ARRAY;
+            case REPR_TABLE:  return ValueType::TABLE;
+            default:          return ValueType::STRING;
+        }
     }
-    
-    double getFloat() const { 
-        return std::get<double>(data_); 
+
+    // View of the string bytes; valid while this Value is alive and unchanged
+    std::string_view getString() const {
+        if (repr() == REPR_SMALL_STRING) {
+            return std::string_view(reinterpret_cast<const char*>(payload_), smallSize());
+        }
+        requireType(ValueType::STRING);
+        return loadWord<StringRep*>()->view();
     }
-    
-    bool getBool() const { 
-        return std::get<bool>(data_); 
+
+    double getFloat() const {
+        requireType(ValueType::FLOAT);
+        return loadWord<double>();
     }
-    
-    const Handle& getHandle() const { 
-        return std::get<Handle>(data_); 
+
+    bool getBool() const {
+        requireType(ValueType::BOOL);
+        return loadWord<bool>();
+    }
+
+    Handle getHandle() const {
+        requireType(ValueType::HANDLE);
+        return loadWord<Handle>();
+    }
+
+    const ArrayRep& getArray() const {
+        requireType(ValueType::ARRAY);
+        return *loadWord<ArrayRep*>();
     }
-    
+
+    const TableRep& getTable() const {
+        requireType(ValueType::TABLE);
+        return *loadWord<TableRep*>();
+    }
+
+    // Element of an ARRAY value, boxed as FLOAT or STRING
+    Value arrayElement(size_t index) const {
+        const ArrayRep& array = getArray();
+        if (index >= array.size()) {
+            throw std::runtime_error("Array index out of range");
+        }
+        if (array.layout() == ArrayRep::Layout::FLOAT) {
+            return Value(array.floatAt(index));
+        }
+        return Value(array.stringAt(index));
+    }
+
+    // Make this a STRING of `length` bytes and return its storage, for a
+    // producer to fill in place. The bytes are undefined until written; the
+    // pointer is valid until this value is next assigned.
+    char* prepareString(size_t length) {
+        releasePayload();
+        if (length <= kInlineCapacity) {
+            setTag(REPR_SMALL_STRING, length);
+            return reinterpret_cast<char*>(payload_);
+        }
+        StringRep* rep = StringRep::createBuffer(length);
+        setTag(REPR_HEAP_STRING);
+        storeWord(rep);
+        return rep->buffer();
+    }
+
+    // Byte length of a STRING value (never flattens a rope)
+    size_t stringSize() const {
+        if (repr() == REPR_HEAP_STRING) {
+            return loadWord<StringRep*>()->size;
+        }
+        return getString().size();
+    }
+
+    // Hash of a STRING value (cached for heap strings)
+    size_t stringHash() const {
+        if (repr() == REPR_HEAP_STRING) {
+            return loadWord<StringRep*>()->hash();
+        }
+        return StringRep::hashChars(getString());
+    }
+
+    // Numeric interpretation without exceptions. STRING values count as
+    // numbers only if the whole text (ignoring surrounding whitespace) is
+    // one; heap strings cache the result, inline ones are short enough to
+    // reparse. Non-numeric strings yield 0.0.
+    bool tryGetNumber(double& out) const {
+        switch (repr()) {
+            case REPR_SMALL_STRING:
+                return parseNumber(getString(), out);
+            case REPR_HEAP_STRING:
+                return loadWord<StringRep*>()->number(out, &Value::parseNumber);
+            case REPR_FLOAT:
+                out = loadWord<double>();
+                return true;
+            case REPR_BOOL:
+                out = loadWord<bool>() ? 1.0 : 0.0;
+                return true;
+            case REPR_HANDLE:
+                out = static_cast<double>(getHandle().id());
+                return true;
+            case REPR_ARRAY:
+            case REPR_TABLE:
+                break;
+        }
+        out = 0.0;
+        return false;
+    }
+
+    bool isNumeric() const {
+        double ignored;
+        return tryGetNumber(ignored);
+    }
+
+    // Text -> number; false (out = 0.0) unless the whole text is a number
+    static bool parseNumber(std::string_view text, double& out) {
+        std::optional<double> number = parseFloat(text);
+        out = number ? *number : 0.0;
+        return number.has_value();
+    }
+
     // Implicit conversions
     Value convertTo(ValueType targetType) const {
-        if (type_ == targetType) return *this;
-        
+        if (getType() == targetType) return *this;
+
         switch (targetType) {
             case ValueType::STRING:
                 return Value(toString());
@@ -67,79 +260,125 @@ public:
             case ValueType::HANDLE:
                 // Cannot convert other types to handle
                 throw std::runtime_error("Cannot convert to handle type");
+            case ValueType::ARRAY:
+                throw std::runtime_error("Cannot convert to array type");
+            case ValueType::TABLE:
+                throw std::runtime_error("Cannot convert to table type");
         }
         return Value();
     }
-    
+
     // String representation
     std::string toString() const {
-        switch (type_) {
+        switch (getType()) {
             case ValueType::STRING:
-                return std::get<std::string>(data_);
+                return std::string(getString());
             case ValueType::FLOAT:
-                return std::to_string(std::get<double>(data_));
+                return floatToString(getFloat());
             case ValueType::BOOL:
-                return std::get<bool>(data_) ? "true" : "false";
+                return getBool() ? "true" : "false";
             case ValueType::HANDLE:
-                return "<handle:" + std::get<Handle>(data_).type + ":" + 
-                       std::to_string(std::get<Handle>(data_).id) + ">";
+                return std::string("<handle:") + handleKindName(getHandle().kind) + ":" +
+                       std::to_string(getHandle().id()) + ">";
+            case ValueType::ARRAY:
+                return getArray().toString();
+            case ValueType::TABLE:
+                return getTable().toString();
         }
         return "";
     }
-    
+
     // Convert to float
     double toFloat() const {
-        switch (type_) {
-            case ValueType::STRING:
-                try {
-                    return std::stod(std::get<std::string>(data_));
-                } catch (...) {
-                    return 0.0;
-                }
+        switch (getType()) {
+            case ValueType::STRING: {
+                double number;
+                tryGetNumber(number);
+                return number;
+            }
             case ValueType::FLOAT:
-                return std::get<double>(data_);
+                return getFloat();
             case ValueType::BOOL:
-                return std::get<bool>(data_) ? 1.0 : 0.0;
+                return getBool() ? 1.0 : 0.0;
             case ValueType::HANDLE:
-                return static_cast<double>(std::get<Handle>(data_).id);
+                return static_cast<double>(getHandle().id());
+            case ValueType::ARRAY:
+                return static_cast<double>(getArray().size());
+            case ValueType::TABLE:
+                return static_cast<double>(getTable().rows);
         }
         return 0.0;
     }
-    
+
     // Convert to bool
     bool toBool() const {
-        switch (type_) {
+        switch (getType()) {
             case ValueType::STRING:
-                return !std::get<std::string>(data_).empty();
+                return !getString().empty();
             case ValueType::FLOAT:
-                return std::abs(std::get<double>(data_)) > 1e-10;
+                return std::abs(getFloat()) > 1e-10;
             case ValueType::BOOL:
-                return std::get<bool>(data_);
+                return getBool();
             case ValueType::HANDLE:
-                return std::get<Handle>(data_).ptr != nullptr;
+                return HandleTable::getInstance().isLive(getHandle());
+            case ValueType::ARRAY:
+                return !getArray().empty();
+            case ValueType::TABLE:
+                return getTable().rows > 0;
         }
         return false;
     }
-    
+
     // Arithmetic operations
-    Value operator+(const Value& other) const {
-        if (type_ == ValueType::STRING || other.type_ == ValueType::STRING) {
+    Value operator+(const Value& other) const & {
+        if (getType() == ValueType::STRING || other.getType() == ValueType::STRING) {
             // String concatenation
-            return Value(this->toString() + other.toString());
+            if (getType() == ValueType::STRING && other.getType() == ValueType::STRING) {
+                return concat(*this, other);
+            }
+            return concat(this->asStringValue(), other.asStringValue());
         } else {
             // Numeric addition
             return Value(this->toFloat() + other.toFloat());
         }
     }
-    
+
+    // Temporary left operand: its buffer is reused, so a + b + c only
+    // reallocates when the spare capacity runs out
+    Value operator+(const Value& other) && {
+        if (&other == this) {
+            return *this + other;   // std::move(x) + x: moving out would empty the right side too
+        }
+        Value result(std::move(*this));
+        result += other;
+        return result;
+    }
+
+    // Same rules as operator+. Appending to a string grows a uniquely owned
+    // buffer geometrically, so append loops reach a steady state with no
+    // allocations.
+    Value& operator+=(const Value& other) {
+        if (getType() != ValueType::STRING && other.getType() != ValueType::STRING) {
+            *this = Value(toFloat() + other.toFloat());
+            return *this;
+        }
+        if (getType() != ValueType::STRING) {
+            *this = asStringValue();
+        }
+        char buffer[kFloatBufferSize];
+        std::string spill;
+        appendText(other.textOf(buffer, spill));
+        return *this;
+    }
+
     Value operator-(const Value& other) const {
         return Value(this->toFloat() - other.toFloat());
     }
-    
+
     Value operator*(const Value& other) const {
         return Value(this->toFloat() * other.toFloat());
     }
-    
+
     Value operator/(const Value& other) const {
         double divisor = other.toFloat();
         if (std::abs(divisor) < 1e-10) {
@@ -147,41 +386,227 @@ public:
         }
         return Value(this->toFloat() / divisor);
     }
-    
+
+    // Outcome of one comparison; every operator reads its answer from it
+    struct Comparison {
+        bool less;    // operator<
+        bool equal;   // operator==
+
+        bool lessEqual() const { return less || equal; }
+        bool greater() const { return !(less || equal); }
+        bool greaterEqual() const { return !less; }
+    };
+
+    // Classifies the operand kinds once and builds no temporaries:
+    //   - if either side is a string, both compare as text (numbers
+    //     formatted on the stack), so "10" == 10 is false
+    //   - otherwise both compare as numbers; equality allows a 1e-10
+    //     difference, while less-than is exact
+    Comparison compare(const Value& other) const {
+        if (getType() == ValueType::STRING || other.getType() == ValueType::STRING) {
+            char lhsBuffer[kFloatBufferSize];
+            char rhsBuffer[kFloatBufferSize];
+            std::string lhsSpill, rhsSpill;
+            int order = compareText(textOf(lhsBuffer, lhsSpill), other.textOf(rhsBuffer, rhsSpill));
+            return Comparison{order < 0, order == 0};
+        }
+        double lhs = toFloat();
+        double rhs = other.toFloat();
+        return Comparison{lhs < rhs, std::abs(lhs - rhs) < 1e-10};
+    }
+
     // Comparison operations
     bool operator==(const Value& other) const {
-        if (type_ == ValueType::STRING || other.type_ == ValueType::STRING) {
-            return this->toString() == other.toString();
-        } else {
-            return std::abs(this->toFloat() - other.toFloat()) < 1e-10;
-        }
+        return compare(other).equal;
     }
-    
+
     bool operator!=(const Value& other) const {
-        return !(*this == other);
+        return !compare(other).equal;
     }
-    
+
     bool operator<(const Value& other) const {
-        if (type_ == ValueType::STRING || other.type_ == ValueType::STRING) {
-            return this->toString() < other.toString();
-        } else {
-            return this->toFloat() < other.toFloat();
-        }
+        return compare(other).less;
     }
-    
+
     bool operator<=(const Value& other) const {
-        return *this < other || *this == other;
+        return compare(other).lessEqual();
     }
-    
+
     bool operator>(const Value& other) const {
-        return !(*this <= other);
+        return compare(other).greater();
     }
-    
+
     bool operator>=(const Value& other) const {
-        return !(*this < other);
+        return compare(other).greaterEqual();
     }
 
 private:
-    ValueType type_;
-    std::variant<std::string, double, bool, Handle> data_;
-};
\ No newline at end of file
+    // Storage kinds behind the public ValueType
+    enum Repr : uint8_t {
+        REPR_SMALL_STRING,
+        REPR_HEAP_STRING,
+        REPR_FLOAT,
+        REPR_BOOL,
+        REPR_HANDLE,
+        REPR_ARRAY,
+        REPR_TABLE
+    };
+
+    // Zeroed so that copying all of it never reads bytes a short string or
+    // a word payload left unset (the constructors overwrite it anyway)
+    alignas(8) unsigned char payload_[kInlineCapacity] = {};
+    uint8_t tag_;   // low 4 bits: Repr, high 4 bits: inline string length
+
+    Repr repr() const { return static_cast<Repr>(tag_ & 0x0F); }
+    size_t smallSize() const { return tag_ >> 4; }
+    void setTag(Repr r, size_t smallLength = 0) {
+        tag_ = static_cast<uint8_t>(r | (smallLength << 4));
+    }
+
+    template <typename T>
+    T loadWord() const {
+        T word;
+        std::memcpy(&word, payload_, sizeof(T));
+        return word;
+    }
+
+    template <typename T>
+    void storeWord(T word) {
+        std::memcpy(payload_, &word, sizeof(T));
+    }
+
+    // Short results are copied into fresh storage; long ones become a rope
+    // node sharing both operands, so repeated appends stay O(1) each
+    static Value concat(const Value& a, const Value& b) {
+        Value result;
+        if (a.stringSize() + b.stringSize() <= kRopeThreshold) {
+            result.setString(a.getString(), b.getString());
+        } else {
+            result.setTag(REPR_HEAP_STRING);
+            result.storeWord(StringRep::concat(a.shareRep(), b.shareRep()));
+        }
+        return result;
+    }
+
+    // This value as a STRING Value; numbers are formatted on the stack, so
+    // short results never touch the heap
+    Value asStringValue() const {
+        switch (getType()) {
+            case ValueType::STRING:
+                return *this;
+            case ValueType::FLOAT: {
+                char buffer[kFloatBufferSize];
+                size_t length = formatFloat(getFloat(), buffer, sizeof(buffer));
+                return Value(std::string_view(buffer, length));
+            }
+            default:
+                return Value(toString());
+        }
+    }
+
+    // New reference to this string's heap rep (inline strings get one made)
+    StringRep* shareRep() const {
+        if (repr() == REPR_HEAP_STRING) {
+            StringRep* rep = loadWord<StringRep*>();
+            rep->retain();
+            return rep;
+        }
+        return StringRep::create(getString());
+    }
+
+    // Store a + b as this value's string (payload must already be released)
+    void setString(std::string_view a, std::string_view b) {
+        if (a.size() + b.size() <= kInlineCapacity) {
+            setTag(REPR_SMALL_STRING, a.size() + b.size());
+            if (!a.empty()) std::memcpy(payload_, a.data(), a.size());
+            if (!b.empty()) std::memcpy(payload_ + a.size(), b.data(), b.size());
+        } else {
+            setTag(REPR_HEAP_STRING);
+            storeWord(StringRep::create(a, b));
+        }
+    }
+
+    void setSmallString(std::string_view s) {
+        setString(s, std::string_view());
+    }
+
+    // STRING only. tail may point into this value's own text.
+    void appendText(std::string_view tail) {
+        if (repr() == REPR_HEAP_STRING && loadWord<StringRep*>()->tryAppend(tail)) {
+            return;
+        }
+        std::string_view head = getString();
+        size_t total = head.size() + tail.size();
+        Value result;
+        if (total <= kInlineCapacity) {
+            result.setString(head, tail);
+        } else {
+            result.setTag(REPR_HEAP_STRING);
+            result.storeWord(StringRep::create(head, tail, total * 2));
+        }
+        *this = std::move(result);
+    }
+
+    static int compareText(std::string_view lhs, std::string_view rhs) {
+        int order = lhs.compare(rhs);
+        return (order > 0) - (order < 0);
+    }
+
+    // Text form for comparisons. Numbers are formatted into buffer; only
+    // handles, arrays and tables need the spill string.
+    std::string_view textOf(char (&buffer)[kFloatBufferSize], std::string& spill) const {
+        switch (getType()) {
+            case ValueType::STRING:
+                return getString();
+            case ValueType::FLOAT:
+                return std::string_view(buffer, formatFloat(getFloat(), buffer, sizeof(buffer)));
+            case ValueType::BOOL:
+                return getBool() ? "true" : "false";
+            case ValueType::HANDLE:
+            case ValueType::ARRAY:
+            case ValueType::TABLE:
+                spill = toString();
+                return spill;
+        }
+        return std::string_view();
+    }
+
+    void requireType(ValueType expected) const {
+        if (getType() != expected) {
+            throw std::runtime_error("Value does not hold the requested type");
+        }
+    }
+
+    // Payload helpers; the target's payload must already be released
+    void copyFrom(const Value& other) {
+        std::memcpy(payload_, other.payload_, kInlineCapacity);
+        tag_ = other.tag_;
+        if (repr() == REPR_HEAP_STRING) {
+            loadWord<StringRep*>()->retain();
+        } else if (repr() == REPR_ARRAY) {
+            retainRef(loadWord<ArrayRep*>());
+        } else if (repr() == REPR_TABLE) {
+            retainRef(loadWord<TableRep*>());
+        }
+    }
+
+    void stealFrom(Value& other) {
+        std::memcpy(payload_, other.payload_, kInlineCapacity);
+        tag_ = other.tag_;
+        // Leave the source as an empty string
+        other.setTag(REPR_SMALL_STRING, 0);
+    }
+
+    void releasePayload() {
+        if (repr() == REPR_HEAP_STRING) {
+            StringRep::release(loadWord<StringRep*>());
+        } else if (repr() == REPR_ARRAY) {
+            releaseRef(loadWord<ArrayRep*>());
+        } else if (repr() == REPR_TABLE) {
+            releaseRef(loadWord<TableRep*>());
+        }
+    }
+};
+// Layout promised above; word payloads (doubles, pointers) sit 8-byte aligned
+static_assert(sizeof(Value) == 16, "Value is 15 payload bytes and a tag byte");
+static_assert(alignof(Value) == 8, "Value payload words are 8-byte aligned");
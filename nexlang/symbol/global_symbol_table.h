@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "symbol_table.h"
+#include "../runtime/snapshot_ptr.h"
+
+// ================= GLOBAL SYMBOL TABLE =================
+// Read-optimized view of the global symbols (operations, functions, blocks,
+// builtins) shared by every block executing in parallel.
+//
+// The base layer is frozen from the SymbolTable once analysis is done and is
+// never modified. Symbols defined at runtime go into an overlay published
+// through a SnapshotPtr, so worker threads resolve globals with plain loads
+// and never take a lock. Overlay definitions shadow the base.
+class GlobalSymbolTable {
+public:
+    // Immutable symbol set with a dense SymbolId index
+    struct Layer {
+        std::vector<Symbol> symbols;
+        std::vector<uint32_t> index;    // SymbolId -> position in symbols + 1 (0 = absent)
+        std::vector<SymbolId> params;   // parameter lists of callables
+
+        const Symbol* find(SymbolId id) const {
+            if (id >= index.size() || index[id] == 0) {
+                return nullptr;
+            }
+            return &symbols[index[id] - 1];
+        }
+
+        void add(const Symbol& sym, const std::vector<SymbolId>& paramNames) {
+            Symbol copy = sym;
+            if (sym.type == SymbolType::FUNCTION || sym.type == SymbolType::OPERATION) {
+                copy.callable = CallableInfo{static_cast<uint32_t>(params.size()),
+                                             static_cast<uint32_t>(paramNames.size())};
+                params.insert(params.end(), paramNames.begin(), paramNames.end());
+            }
+
+            if (sym.id >= index.size()) {
+                index.resize(sym.id + 1, 0);
+            }
+            if (index[sym.id] != 0) {
+                symbols[index[sym.id] - 1] = copy;
+            } else {
+                symbols.push_back(copy);
+                index[sym.id] = static_cast<uint32_t>(symbols.size());
+            }
+        }
+    };
+
+    // Freeze every non-variable symbol visible in the analyzer's table
+    explicit GlobalSymbolTable(const SymbolTable& table) {
+        table.forEachVisible([&](const Symbol& sym) {
+            if (sym.type != SymbolType::VARIABLE) {
+                base_.add(sym, table.paramNames(sym));
+            }
+        });
+    }
+
+    GlobalSymbolTable(const GlobalSymbolTable&) = delete;
+    GlobalSymbolTable& operator=(const GlobalSymbolTable&) = delete;
+
+    // A symbol and its parameter names, both read from the same layer.
+    // callable.firstParam indexes that layer's params, so the names must not
+    // be looked up again later: an overlay published in between may no
+    // longer hold the symbol.
+    struct Resolved {
+        const Symbol* symbol = nullptr;
+        const SymbolId* params = nullptr;   // FUNCTION / OPERATION only
+        uint32_t paramCount = 0;
+
+        explicit operator bool() const { return symbol != nullptr; }
+
+        std::vector<SymbolId> paramNames() const {
+            return std::vector<SymbolId>(params, params + paramCount);
+        }
+    };
+
+    // Lock-free lookup, safe from any thread
+    Resolved resolve(SymbolId id) const {
+        if (const Layer* overlay = overlay_.load()) {
+            if (const Symbol* sym = overlay->find(id)) {
+                return resolved(*overlay, sym);
+            }
+        }
+        return resolved(base_, base_.find(id));
+    }
+
+    Resolved resolve(const std::string& name) const {
+        return resolve(StringInterner::getInstance().find(name));
+    }
+
+    const Symbol* lookup(SymbolId id) const {
+        return resolve(id).symbol;
+    }
+
+    const Symbol* lookup(const std::string& name) const {
+        return resolve(name).symbol;
+    }
+
+    // Define (or redefine) a global while blocks are running. Writers are
+    // serialized; readers keep seeing the previous overlay until the new one
+    // is published.
+    void defineRuntime(const Symbol& sym, const std::vector<SymbolId>& paramNames = {}) {
+        overlay_.update([&](Layer& next) {
+            next.add(sym, paramNames);
+        });
+    }
+
+    // Release superseded overlays; only when no worker thread is running
+    void reclaim() {
+        overlay_.reclaim();
+    }
+
+private:
+    Layer base_;
+    SnapshotPtr<Layer> overlay_;
+
+    static Resolved resolved(const Layer& layer, const Symbol* sym) {
+        Resolved result;
+        result.symbol = sym;
+        if (sym && (sym->type == SymbolType::FUNCTION || sym->type == SymbolType::OPERATION)) {
+            result.params = layer.params.data() + sym->callable.firstParam;
+            result.paramCount = sym->callable.paramCount;
+        }
+        return result;
+    }
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Compact ID for an interned identifier or string literal
+using SymbolId = uint32_t;
+
+constexpr SymbolId kInvalidSymbolId = std::numeric_limits<SymbolId>::max();
+
+// ================= STRING INTERNER =================
+// Process-wide table mapping every identifier and string literal to a dense
+// integer ID. Interning happens once at lex time; afterwards names are
+// compared and hashed as plain integers. Safe to use from multiple threads.
+class StringInterner {
+public:
+    static StringInterner& getInstance() {
+        static StringInterner instance;
+        return instance;
+    }
+
+    // Return the ID for text, assigning a new one on first sight
+    SymbolId intern(std::string_view text) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = ids_.find(text);
+            if (it != ids_.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(text);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+
+        SymbolId id = static_cast<SymbolId>(strings_.size());
+        strings_.emplace_back(text);
+        ids_.emplace(std::string_view(strings_.back()), id);
+        return id;
+    }
+
+    // Return the ID for text without interning it (kInvalidSymbolId if unseen)
+    SymbolId find(std::string_view text) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(text);
+        return it != ids_.end() ? it->second : kInvalidSymbolId;
+    }
+
+    // Text of an interned ID (the reference stays valid for the process lifetime)
+    const std::string& text(SymbolId id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return strings_.at(id);
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return strings_.size();
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> strings_;                        // stable storage, indexed by ID
+    std::unordered_map<std::string_view, SymbolId> ids_;     // views into strings_
+
+    StringInterner() = default;
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+};
+
+// Shorthand for StringInterner::getInstance().intern()
+inline SymbolId internString(std::string_view text) {
+    return StringInterner::getInstance().intern(text);
+}
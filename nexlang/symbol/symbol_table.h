@@ -1,14 +1,15 @@
 #pragma once
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <memory>
-#include <stack>
 #include <vector>
 #include <stdexcept>
 #include "../runtime/value.h"
+#include "string_interner.h"
+#include "../builtins/builtins_registry.h"
 
 // ================= SYMBOL TYPES =================
-enum class SymbolType {
+enum class SymbolType : uint8_t {
     VARIABLE,
     FUNCTION,
     OPERATION,
@@ -16,180 +17,289 @@ enum class SymbolType {
     BUILTIN
 };
 
-// Base symbol class
-class Symbol {
-public:
-    std::string name;
-    SymbolType type;
-    Value value;
-    
-    Symbol(const std::string& n, SymbolType t, const Value& v = Value())
-        : name(n), type(t), value(v) {}
-    virtual ~Symbol() = default;
-};
+// Handle to a slot in the SymbolPool
+using SymbolHandle = uint32_t;
 
-// Variable symbol
-class VariableSymbol : public Symbol {
-public:
+constexpr SymbolHandle kInvalidSymbolHandle = UINT32_MAX;
+
+// ================= SYMBOL PAYLOADS =================
+// Kind-specific data; all trivially copyable so they can share one union
+
+struct VariableInfo {
     bool isMutable;  // Let variables are mutable
-    
-    VariableSymbol(const std::string& n, const Value& v, bool mut = true)
-        : Symbol(n, SymbolType::VARIABLE, v), isMutable(mut) {}
 };
 
-// Function symbol
-class FunctionSymbol : public Symbol {
-public:
-    std::vector<std::string> paramNames;
-    
-    FunctionSymbol(const std::string& n, const std::vector<std::string>& params)
-        : Symbol(n, SymbolType::FUNCTION), paramNames(params) {}
+// FUNCTION and OPERATION: range of parameter names in SymbolTable's param list
+struct CallableInfo {
+    uint32_t firstParam;
+    uint32_t paramCount;
 };
 
-// Operation symbol
-class OperationSymbol : public Symbol {
-public:
-    std::vector<std::string> paramNames;
-    
-    OperationSymbol(const std::string& n, const std::vector<std::string>& params)
-        : Symbol(n, SymbolType::OPERATION), paramNames(params) {}
+struct BlockInfo {
+    int blockId;
 };
 
-// Block symbol
-class BlockSymbol : public Symbol {
-public:
-    int blockId;
-    
-    BlockSymbol(const std::string& n, int id)
-        : Symbol(n, SymbolType::BLOCK), blockId(id) {}
+// Resolved once when the symbol is defined; calls dispatch by index
+struct BuiltinInfo {
+    BuiltinId id;   // kInvalidBuiltinId if the registry has no implementation
 };
 
-// Built-in symbol
-class BuiltInSymbol : public Symbol {
-public:
-    std::string implementation;
-    
-    BuiltInSymbol(const std::string& n, const std::string& impl)
-        : Symbol(n, SymbolType::BUILTIN), implementation(impl) {}
+// ================= SYMBOL =================
+// One non-virtual layout for every kind: `type` selects the active payload.
+struct Symbol {
+    SymbolId id = kInvalidSymbolId;    // interned name
+    SymbolType type = SymbolType::VARIABLE;
+    Value value;
+    union {
+        VariableInfo variable;
+        CallableInfo callable;
+        BlockInfo block;
+        BuiltinInfo builtin;
+    };
+
+    Symbol() : callable{0, 0} {}
+
+    const std::string& name() const {
+        return StringInterner::getInstance().text(id);
+    }
 };
 
-// ================= SCOPE =================
-class Scope {
+// ================= SYMBOL POOL =================
+// Symbols are stored in fixed-size chunks so Symbol* stays valid while the
+// pool grows. Released slots are recycled through a free list.
+class SymbolPool {
 public:
-    std::unordered_map<std::string, std::shared_ptr<Symbol>> symbols;
-    std::shared_ptr<Scope> parent;
-    
-    Scope(std::shared_ptr<Scope> p = nullptr) : parent(p) {}
-    
-    // Define a symbol in this scope
-    void define(const std::string& name, std::shared_ptr<Symbol> symbol) {
-        symbols[name] = symbol;
-    }
-    
-    // Look up a symbol (check this scope first, then parent scopes)
-    std::shared_ptr<Symbol> lookup(const std::string& name) {
-        auto it = symbols.find(name);
-        if (it != symbols.end()) {
-            return it->second;
-        }
-        
-        if (parent) {
-            return parent->lookup(name);
+    SymbolHandle allocate(SymbolId id, SymbolType type, Value value) {
+        SymbolHandle handle;
+        if (!freeList_.empty()) {
+            handle = freeList_.back();
+            freeList_.pop_back();
+        } else {
+            if ((used_ & kChunkMask) == 0) {
+                chunks_.push_back(std::make_unique<Symbol[]>(kChunkSize));
+            }
+            handle = used_++;
         }
-        
-        return nullptr;
+
+        Symbol& sym = (*this)[handle];
+        sym.id = id;
+        sym.type = type;
+        sym.value = std::move(value);
+        return handle;
     }
-    
-    // Check if symbol exists in current scope only
-    bool hasLocal(const std::string& name) {
-        return symbols.find(name) != symbols.end();
+
+    void release(SymbolHandle handle) {
+        (*this)[handle].value = Value();   // drop any payload the value owns
+        freeList_.push_back(handle);
+    }
+
+    Symbol& operator[](SymbolHandle handle) {
+        return chunks_[handle >> kChunkBits][handle & kChunkMask];
     }
+
+    const Symbol& operator[](SymbolHandle handle) const {
+        return chunks_[handle >> kChunkBits][handle & kChunkMask];
+    }
+
+private:
+    static constexpr uint32_t kChunkBits = 8;
+    static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+    static constexpr uint32_t kChunkMask = kChunkSize - 1;
+
+    std::vector<std::unique_ptr<Symbol[]>> chunks_;
+    std::vector<SymbolHandle> freeList_;
+    uint32_t used_ = 0;
+};
+
+// ================= SCOPE STACK =================
+// Every live symbol sits in one flat vector. A scope is only the index at
+// which it started, so entering/leaving a scope never allocates a table.
+// Each name ID keeps a shadow stack of entry indices; its top is the
+// innermost visible definition.
+struct ScopeEntry {
+    SymbolId id;
+    SymbolHandle handle;
 };
 
 // ================= SYMBOL TABLE =================
 class SymbolTable {
 public:
-    std::shared_ptr<Scope> currentScope;
-    
     SymbolTable() {
-        // Create global scope
-        currentScope = std::make_shared<Scope>();
+        // The global scope starts at entry 0 and is never popped
         initializeBuiltIns();
     }
-    
+
     // Enter a new scope
     void enterScope() {
-        currentScope = std::make_shared<Scope>(currentScope);
+        scopeStarts.push_back(entries.size());
     }
-    
-    // Exit current scope
+
+    // Exit current scope, dropping every symbol defined since it was entered
     void exitScope() {
-        if (currentScope->parent) {
-            currentScope = currentScope->parent;
+        if (scopeStarts.empty()) {
+            return;
+        }
+
+        size_t start = scopeStarts.back();
+        scopeStarts.pop_back();
+
+        while (entries.size() > start) {
+            shadowStacks[entries.back().id].pop_back();
+            pool.release(entries.back().handle);
+            entries.pop_back();
         }
     }
-    
-    // Define a symbol in current scope
-    void define(std::shared_ptr<Symbol> symbol) {
-        currentScope->define(symbol->name, symbol);
+
+    // Define a symbol in current scope (redefinition replaces the local one)
+    Symbol& define(SymbolId id, SymbolType type, Value value = Value()) {
+        if (id >= shadowStacks.size()) {
+            shadowStacks.resize(id + 1);
+        }
+        std::vector<size_t>& shadow = shadowStacks[id];
+        SymbolHandle handle = pool.allocate(id, type, std::move(value));
+
+        if (!shadow.empty() && shadow.back() >= currentScopeStart()) {
+            ScopeEntry& local = entries[shadow.back()];
+            pool.release(local.handle);
+            local.handle = handle;
+        } else {
+            shadow.push_back(entries.size());
+            entries.push_back(ScopeEntry{id, handle});
+        }
+        return pool[handle];
     }
-    
-    // Look up a symbol in all scopes
-    std::shared_ptr<Symbol> lookup(const std::string& name) {
-        return currentScope->lookup(name);
+
+    // Look up a symbol in all scopes (innermost definition wins)
+    SymbolHandle lookupHandle(SymbolId id) const {
+        if (id >= shadowStacks.size() || shadowStacks[id].empty()) {
+            return kInvalidSymbolHandle;
+        }
+        return entries[shadowStacks[id].back()].handle;
     }
-    
+
+    Symbol* lookup(SymbolId id) {
+        SymbolHandle handle = lookupHandle(id);
+        return handle != kInvalidSymbolHandle ? &pool[handle] : nullptr;
+    }
+
+    // Names that were never interned cannot name a symbol
+    Symbol* lookup(const std::string& name) {
+        return lookup(StringInterner::getInstance().find(name));
+    }
+
+    Symbol& get(SymbolHandle handle) {
+        return pool[handle];
+    }
+
+    // Check if symbol exists in current scope only
+    bool hasLocal(SymbolId id) {
+        return id < shadowStacks.size() && !shadowStacks[id].empty() &&
+               shadowStacks[id].back() >= currentScopeStart();
+    }
+
+    bool hasLocal(const std::string& name) {
+        return hasLocal(StringInterner::getInstance().find(name));
+    }
+
+    // Current nesting depth (0 = global scope)
+    size_t scopeDepth() const {
+        return scopeStarts.size();
+    }
+
     // Define a variable
-    void defineVariable(const std::string& name, const Value& value, bool isMutable = true) {
-        auto var = std::make_shared<VariableSymbol>(name, value, isMutable);
-        define(var);
+    void defineVariable(const std::string& name, Value value, bool isMutable = true) {
+        Symbol& var = define(internString(name), SymbolType::VARIABLE, std::move(value));
+        var.variable.isMutable = isMutable;
     }
-    
+
     // Define a function
-    void defineFunction(const std::string& name, const std::vector<std::string>& paramNames) {
-        auto func = std::make_shared<FunctionSymbol>(name, paramNames);
-        define(func);
+    void defineFunction(const std::string& name, const std::vector<SymbolId>& paramNames) {
+        Symbol& func = define(internString(name), SymbolType::FUNCTION);
+        func.callable = storeParams(paramNames);
     }
-    
+
     // Define an operation
-    void defineOperation(const std::string& name, const std::vector<std::string>& paramNames) {
-        auto op = std::make_shared<OperationSymbol>(name, paramNames);
-        define(op);
+    void defineOperation(const std::string& name, const std::vector<SymbolId>& paramNames) {
+        Symbol& op = define(internString(name), SymbolType::OPERATION);
+        op.callable = storeParams(paramNames);
     }
-    
+
     // Define a block
     void defineBlock(const std::string& name, int blockId) {
-        auto block = std::make_shared<BlockSymbol>(name, blockId);
-        define(block);
+        Symbol& block = define(internString(name), SymbolType::BLOCK);
+        block.block.blockId = blockId;
     }
-    
+
+    // Parameter names of a FUNCTION or OPERATION symbol
+    std::vector<SymbolId> paramNames(const Symbol& sym) const {
+        auto first = params.begin() + sym.callable.firstParam;
+        return std::vector<SymbolId>(first, first + sym.callable.paramCount);
+    }
+
+    // Call fn(const Symbol&) for every symbol visible from the current scope
+    template <typename Fn>
+    void forEachVisible(Fn&& fn) const {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (shadowStacks[entries[i].id].back() == i) {
+                fn(pool[entries[i].handle]);
+            }
+        }
+    }
+
     // Check if variable exists
-    bool hasVariable(const std::string& name) {
-        auto sym = lookup(name);
+    bool hasVariable(SymbolId id) {
+        auto sym = lookup(id);
         return sym && sym->type == SymbolType::VARIABLE;
     }
-    
+
+    bool hasVariable(const std::string& name) {
+        return hasVariable(StringInterner::getInstance().find(name));
+    }
+
     // Update variable value (if mutable)
-    bool updateVariable(const std::string& name, const Value& newValue) {
-        auto sym = lookup(name);
-        if (sym && sym->type == SymbolType::VARIABLE) {
-            auto varSym = std::dynamic_pointer_cast<VariableSymbol>(sym);
-            if (varSym && varSym->isMutable) {
-                varSym->value = newValue;
-                return true;
-            }
+    bool updateVariable(SymbolId id, Value newValue) {
+        auto sym = lookup(id);
+        if (sym && sym->type == SymbolType::VARIABLE && sym->variable.isMutable) {
+            sym->value = std::move(newValue);
+            return true;
         }
         return false;
     }
-    
+
+    bool updateVariable(const std::string& name, Value newValue) {
+        return updateVariable(StringInterner::getInstance().find(name), std::move(newValue));
+    }
+
 private:
+    SymbolPool pool;
+    std::vector<ScopeEntry> entries;
+    std::vector<size_t> scopeStarts;
+    std::vector<std::vector<size_t>> shadowStacks;   // indexed by SymbolId
+    std::vector<SymbolId> params;                    // parameter lists of callables
+
+    size_t currentScopeStart() const {
+        return scopeStarts.empty() ? 0 : scopeStarts.back();
+    }
+
+    CallableInfo storeParams(const std::vector<SymbolId>& paramNames) {
+        CallableInfo info{static_cast<uint32_t>(params.size()),
+                          static_cast<uint32_t>(paramNames.size())};
+        params.insert(params.end(), paramNames.begin(), paramNames.end());
+        return info;
+    }
+
+    void defineBuiltIn(const std::string& name) {
+        Symbol& builtin = define(internString(name), SymbolType::BUILTIN);
+        builtin.builtin.id = BuiltinsRegistry::getInstance().resolve(builtin.id);
+    }
+
     // Initialize built-in functions
     void initializeBuiltIns() {
         // Define common built-ins
-        define(std::make_shared<BuiltInSymbol>("Say", "print"));
-        define(std::make_shared<BuiltInSymbol>("open", "file_open"));
-        define(std::make_shared<BuiltInSymbol>("Read", "file_read"));
-        define(std::make_shared<BuiltInSymbol>("Write", "file_write"));
-        define(std::make_shared<BuiltInSymbol>("DO", "execute"));
+        defineBuiltIn("Say");
+        defineBuiltIn("open");
+        defineBuiltIn("Read");
+        defineBuiltIn("Write");
+        defineBuiltIn("DO");      // statement form, no registry entry
     }
 };
\ No newline at end of file
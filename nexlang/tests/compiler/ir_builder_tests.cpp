@@ -0,0 +1,172 @@
+// IR builder tests: constant folding and intrinsic lowering
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "../../compiler/ir/ir_builder.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static BuiltinId builtinId(const char* name) {
+    return BuiltinsRegistry::getInstance().resolve(name);
+}
+
+// Value of a given static type that is not a constant
+static IrValueId opaque(IrBuilder& builder, IrType type) {
+    return builder.call(builtinId("Say"), {}, type);
+}
+
+static Value floatArray(std::vector<double> numbers) {
+    ArrayRep* array = new ArrayRep();
+    for (double number : numbers) {
+        array->appendFloat(number);
+    }
+    return Value(array);
+}
+
+// ================= FOLDING =================
+static void testFoldConstants() {
+    IrFunction function;
+    IrBuilder builder(function);
+    IrValueId sum = builder.callBuiltin(builtinId("Add"), {builder.constant(Value(2.0)), builder.constant(Value(3.0))});
+    check(builder.isConstant(sum) && builder.constantValue(sum).getFloat() == 5.0, "Add of constants folds");
+    check(function.def(sum).type == IrType::FLOAT, "folded constant is typed");
+
+    IrValueId text = builder.callBuiltin(builtinId("Concat"), {builder.constant(Value("ab")), builder.constant(Value("cd"))});
+    check(builder.isConstant(text) && builder.constantValue(text).getString() == "abcd", "Concat of constants folds");
+
+    IrValueId nested = builder.callBuiltin(builtinId("Multiply"), {sum, builder.constant(Value(4.0))});
+    check(builder.isConstant(nested) && builder.constantValue(nested).getFloat() == 20.0, "folded results fold again");
+
+    IrValueId total = builder.callBuiltin(builtinId("Batch_Sum"), {builder.constant(floatArray({1.0, 2.0, 3.5}))});
+    check(builder.isConstant(total) && builder.constantValue(total).getFloat() == 6.5, "batch builtin of a constant array");
+}
+
+static void testNoFoldOnError() {
+    IrFunction function;
+    IrBuilder builder(function);
+    IrValueId quotient = builder.callBuiltin(builtinId("Divide"), {builder.constant(Value(1.0)), builder.constant(Value(0.0))});
+    check(function.def(quotient).op == IrOp::CALL_BUILTIN, "Divide by zero is left for run time");
+    IrValueId half = builder.callBuiltin(builtinId("Divide"), {builder.constant(Value(1.0)), builder.constant(Value(2.0))});
+    check(builder.isConstant(half) && builder.constantValue(half).getFloat() == 0.5, "Divide by non-zero folds");
+
+    // Any exception type keeps the call, not just runtime_error
+    BuiltinId failing = BuiltinsRegistry::getInstance().registerBuiltin(
+        "Test_LogicError", BuiltinKind::MATH_OP, 1,
+        [](ValueSpan, Value&) { throw std::logic_error("not at compile time"); }, true);
+    IrValueId failed = builder.callBuiltin(failing, {builder.constant(Value(1.0))});
+    check(function.def(failed).op == IrOp::CALL_BUILTIN, "logic_error during folding is left for run time");
+}
+
+static void testNoFoldWithoutConstants() {
+    IrFunction function;
+    IrBuilder builder(function);
+    IrValueId x = opaque(builder, IrType::UNKNOWN);
+    IrValueId sum = builder.callBuiltin(builtinId("Add"), {x, builder.constant(Value(1.0))});
+    check(function.def(sum).op == IrOp::CALL_BUILTIN, "non-constant operand is not folded");
+    IrValueId said = builder.callBuiltin(builtinId("Say"), {builder.constant(Value("hi"))});
+    check(function.def(said).op == IrOp::CALL_BUILTIN, "impure builtin is not folded");
+}
+
+// ================= LOWERING =================
+static void testLowerScalarOps() {
+    IrFunction function;
+    IrBuilder builder(function);
+    IrValueId x = opaque(builder, IrType::FLOAT);
+    IrValueId y = opaque(builder, IrType::FLOAT);
+    const struct {
+        const char* name;
+        IrOp op;
+    } cases[] = {{"Add", IrOp::FADD}, {"Subtract", IrOp::FSUB}, {"Multiply", IrOp::FMUL}};
+    for (const auto& c : cases) {
+        IrValueId lowered = builder.callBuiltin(builtinId(c.name), {x, y});
+        check(function.def(lowered).op == c.op && function.def(lowered).type == IrType::FLOAT,
+              "FLOAT operands lower to the scalar op");
+        check(function.def(lowered).operands == std::vector<IrValueId>({x, y}), "lowered op keeps its operands");
+
+        IrValueId mixed = builder.callBuiltin(builtinId(c.name), {x, opaque(builder, IrType::STRING)});
+        check(function.def(mixed).op == IrOp::CALL_BUILTIN, "STRING operand stays a call");
+        IrValueId unknown = builder.callBuiltin(builtinId(c.name), {opaque(builder, IrType::UNKNOWN), y});
+        check(function.def(unknown).op == IrOp::CALL_BUILTIN, "UNKNOWN operand stays a call");
+        IrValueId flag = builder.callBuiltin(builtinId(c.name), {x, opaque(builder, IrType::BOOL)});
+        check(function.def(flag).op == IrOp::CALL_BUILTIN, "BOOL operand stays a call");
+    }
+    IrValueId quotient = builder.callBuiltin(builtinId("Divide"), {x, y});
+    check(function.def(quotient).op == IrOp::CALL_BUILTIN, "Divide has no lowering");
+}
+
+static void testLowerVectorOps() {
+    IrFunction function;
+    IrBuilder builder(function);
+    IrValueId a = opaque(builder, IrType::FLOAT_ARRAY);
+    IrValueId b = opaque(builder, IrType::FLOAT_ARRAY);
+    IrValueId c = opaque(builder, IrType::FLOAT_ARRAY);
+    IrValueId anyArray = opaque(builder, IrType::ARRAY);
+
+    const struct {
+        const char* name;
+        IrOp op;
+        IrType type;
+    } binary[] = {{"Batch_Add", IrOp::VADD, IrType::FLOAT_ARRAY}, {"Batch_Multiply", IrOp::VMUL, IrType::FLOAT_ARRAY},
+                  {"Batch_Less", IrOp::VCMP_LT, IrType::FLOAT_ARRAY}, {"Batch_Equal", IrOp::VCMP_EQ, IrType::FLOAT_ARRAY},
+                  {"Batch_Greater", IrOp::VCMP_GT, IrType::FLOAT_ARRAY}, {"Batch_Dot", IrOp::VDOT, IrType::FLOAT}};
+    for (const auto& op : binary) {
+        IrValueId lowered = builder.callBuiltin(builtinId(op.name), {a, b});
+        check(function.def(lowered).op == op.op && function.def(lowered).type == op.type,
+              "FLOAT_ARRAY operands lower to the vector op");
+        IrValueId call = builder.callBuiltin(builtinId(op.name), {a, anyArray});
+        check(function.def(call).op == IrOp::CALL_BUILTIN && function.def(call).type == IrType::UNKNOWN,
+              "ARRAY of unknown layout stays an untyped call");
+    }
+
+    IrValueId fma = builder.callBuiltin(builtinId("Batch_FMA"), {a, b, c});
+    check(function.def(fma).op == IrOp::VFMA && function.def(fma).type == IrType::FLOAT_ARRAY, "Batch_FMA lowers");
+    const struct {
+        const char* name;
+        IrOp op;
+    } reductions[] = {{"Batch_Sum", IrOp::VSUM}, {"Batch_Min", IrOp::VMIN}, {"Batch_Max", IrOp::VMAX}};
+    for (const auto& op : reductions) {
+        IrValueId lowered = builder.callBuiltin(builtinId(op.name), {a});
+        check(function.def(lowered).op == op.op && function.def(lowered).type == IrType::FLOAT, "reduction lowers");
+        IrValueId scalar = builder.callBuiltin(builtinId(op.name), {opaque(builder, IrType::FLOAT)});
+        check(function.def(scalar).op == IrOp::CALL_BUILTIN, "FLOAT operand of a reduction stays a call");
+    }
+
+    Value strings = Value("x");
+    IrValueId constantText = builder.constant(strings);
+    IrValueId call = builder.callBuiltin(builtinId("Batch_Sum"), {constantText});
+    check(function.def(call).op != IrOp::VSUM, "STRING constant is not a FLOAT array");
+}
+
+static void testArityMismatch() {
+    IrFunction function;
+    IrBuilder builder(function);
+    IrValueId x = opaque(builder, IrType::FLOAT);
+    IrValueId one = builder.callBuiltin(builtinId("Add"), {x});
+    check(function.def(one).op == IrOp::CALL_BUILTIN, "too few operands stay a call");
+    IrValueId three = builder.callBuiltin(builtinId("Add"), {x, x, x});
+    check(function.def(three).op == IrOp::CALL_BUILTIN, "too many operands stay a call");
+    IrValueId a = opaque(builder, IrType::FLOAT_ARRAY);
+    IrValueId fma = builder.callBuiltin(builtinId("Batch_FMA"), {a, a});
+    check(function.def(fma).op == IrOp::CALL_BUILTIN, "vector op with missing operands stays a call");
+}
+
+int main() {
+    testFoldConstants();
+    testNoFoldOnError();
+    testNoFoldWithoutConstants();
+    testLowerScalarOps();
+    testLowerVectorOps();
+    testArityMismatch();
+
+    if (failures == 0) {
+        std::cout << "All IR builder tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+// Runtime allocator tests
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../runtime/allocator.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static bool aligned(const void* p, size_t align) {
+    return reinterpret_cast<uintptr_t>(p) % align == 0;
+}
+
+// ================= ARENA =================
+static void testArenaAlignment() {
+    Arena arena;
+    arena.allocate(1, 1);
+    void* p16 = arena.allocate(8, 16);
+    arena.allocate(3, 1);
+    void* p64 = arena.allocate(8, 64);
+    double* d = arena.create<double>(2.5);
+    check(aligned(p16, 16), "16-byte alignment");
+    check(aligned(p64, 64), "64-byte alignment");
+    check(aligned(d, alignof(double)) && *d == 2.5, "created object is aligned");
+}
+
+static void testArenaReuseAfterRewind() {
+    Arena arena;
+    Arena::Mark start = arena.mark();
+    char* first = static_cast<char*>(arena.allocate(100));
+    for (int i = 0; i < 2000; ++i) {
+        arena.allocate(100);   // spills into further chunks
+    }
+    arena.rewind(start);
+    check(arena.bytesInUse() == 0, "rewind to the start releases everything");
+    check(arena.allocate(100) == first, "memory is handed out again after rewind");
+
+    Arena::Mark middle = arena.mark();
+    void* again = arena.allocate(32);
+    arena.rewind(middle);
+    check(arena.allocate(32) == again, "rewind to a mark reuses what followed it");
+}
+
+static void testArenaLargeBlocks() {
+    Arena arena;
+    arena.allocate(10);
+    Arena::Mark m = arena.mark();
+    size_t large = Arena::kChunkSize * 3;
+    char* block = static_cast<char*>(arena.allocate(large, 32));
+    check(aligned(block, 32), "large block alignment");
+    std::memset(block, 0x5a, large);   // the whole block is usable
+    check(arena.bytesInUse() >= large, "large block is counted");
+    arena.rewind(m);
+    check(arena.bytesInUse() < Arena::kChunkSize, "rewind drops the large block");
+    char* small = static_cast<char*>(arena.allocate(10));
+    check(small != nullptr, "small allocation after a large one");
+}
+
+static int destroyed = 0;
+
+struct Tracked {
+    int order;
+    std::string text;
+    ~Tracked() { destroyed = destroyed * 10 + order; }
+};
+
+static void testArenaFinalizers() {
+    destroyed = 0;
+    Arena arena;
+    arena.create<Tracked>(Tracked{1, std::string(40, 'a')});
+    destroyed = 0;   // the temporary above
+    Arena::Mark m = arena.mark();
+    arena.create<Tracked>(Tracked{2, "b"});
+    arena.create<Tracked>(Tracked{3, "c"});
+    destroyed = 0;
+    arena.rewind(m);
+    check(destroyed == 32, "objects after the mark are destroyed in reverse order");
+    destroyed = 0;
+    arena.reset();
+    check(destroyed == 1, "reset destroys the rest");
+}
+
+static void testArenaAllocator() {
+    Arena arena;
+    std::vector<int, ArenaAllocator<int>> numbers{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 10000; ++i) {
+        numbers.push_back(i);
+    }
+    check(numbers[9999] == 9999, "vector over an arena");
+    check(arena.bytesInUse() >= 10000 * sizeof(int), "vector storage comes from the arena");
+}
+
+// ================= SIZE-CLASS POOLS =================
+static void testSizeClasses() {
+    check(PoolAllocator::sizeClass(1) == 0 && PoolAllocator::sizeClass(16) == 0, "smallest class");
+    check(PoolAllocator::sizeClass(17) == 1, "next class");
+    check(PoolAllocator::sizeClass(PoolAllocator::kMaxBlock) == PoolAllocator::kClassCount - 1, "largest class");
+    check(PoolAllocator::blockSize(3) == 128, "block size of a class");
+}
+
+static void testPoolReuse() {
+    PoolAllocator& pool = PoolAllocator::getInstance();
+    void* p = pool.allocate(40);
+    pool.deallocate(p, 40);
+    check(pool.allocate(33) == p, "freed block is reused by the same class");
+    pool.deallocate(p, 33);
+
+    // More than the thread cache holds: blocks go back to the shared lists
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        blocks.push_back(pool.allocate(24));
+    }
+    check(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size(), "live blocks are distinct");
+    for (void* block : blocks) {
+        pool.deallocate(block, 24);
+    }
+    std::set<void*> previous(blocks.begin(), blocks.end());
+    size_t reused = 0;
+    for (int i = 0; i < 1000; ++i) {
+        void* block = pool.allocate(24);
+        reused += previous.count(block);
+        blocks[i] = block;
+    }
+    // Only the unused rest of the last batch taken may come out first
+    check(reused + PoolAllocator::kBatch >= blocks.size(), "freed blocks are handed out again");
+    for (void* block : blocks) {
+        pool.deallocate(block, 24);
+    }
+}
+
+static void testPoolAlignment() {
+    PoolAllocator& pool = PoolAllocator::getInstance();
+    for (size_t size = 1; size <= PoolAllocator::kMaxBlock; size *= 2) {
+        void* p = pool.allocate(size);
+        check(aligned(p, 16), "pool blocks are 16-byte aligned");
+        std::memset(p, 0xa5, size);
+        pool.deallocate(p, size);
+    }
+}
+
+static void testPoolLargeFallback() {
+    PoolAllocator& pool = PoolAllocator::getInstance();
+    size_t large = PoolAllocator::kMaxBlock + 1;
+    void* p = pool.allocate(large);
+    check(p != nullptr && aligned(p, alignof(std::max_align_t)), "large request falls back to the heap");
+    std::memset(p, 0x11, large);
+    pool.deallocate(p, large);
+    pool.deallocate(nullptr, 16);
+}
+
+static void testPoolAcrossThreads() {
+    // Blocks allocated on one thread and freed on another end up shared
+    std::vector<void*> blocks(500);
+    std::thread producer([&] {
+        for (void*& block : blocks) {
+            block = PoolAllocator::getInstance().allocate(64);
+            std::memset(block, 0x3c, 64);
+        }
+    });
+    producer.join();
+    std::thread consumer([&] {
+        for (void* block : blocks) {
+            PoolAllocator::getInstance().deallocate(block, 64);
+        }
+    });
+    consumer.join();
+    std::set<void*> freed(blocks.begin(), blocks.end());
+    size_t reused = 0;
+    std::vector<void*> again;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        again.push_back(PoolAllocator::getInstance().allocate(64));
+        reused += freed.count(again.back());
+    }
+    check(reused > 0, "blocks freed by an exited thread are reused");
+    for (void* block : again) {
+        PoolAllocator::getInstance().deallocate(block, 64);
+    }
+}
+
+// Frees its block from a thread_local destructor. Constructed before the
+// thread first uses the pool, so it is destroyed after the thread's cache.
+struct ReleaseAtExit {
+    void* block = nullptr;
+    void** reallocated = nullptr;
+
+    ~ReleaseAtExit() {
+        PoolAllocator& pool = PoolAllocator::getInstance();
+        pool.deallocate(block, PoolAllocator::kMaxBlock);
+        *reallocated = pool.allocate(PoolAllocator::kMaxBlock);
+        pool.deallocate(*reallocated, PoolAllocator::kMaxBlock);
+    }
+};
+
+static void testPoolAfterThreadCache() {
+    void* block = nullptr;
+    void* reallocated = nullptr;
+    std::thread exiting([&] {
+        thread_local ReleaseAtExit release;
+        release.reallocated = &reallocated;
+        release.block = PoolAllocator::getInstance().allocate(PoolAllocator::kMaxBlock);
+        block = release.block;
+    });
+    exiting.join();
+    // Both went straight to the shared list, so a fresh thread gets the block first
+    check(block && reallocated == block, "pool works after the thread cache is destroyed");
+    void* fresh = nullptr;
+    std::thread next([&] {
+        fresh = PoolAllocator::getInstance().allocate(PoolAllocator::kMaxBlock);
+        PoolAllocator::getInstance().deallocate(fresh, PoolAllocator::kMaxBlock);
+    });
+    next.join();
+    check(fresh == block, "block freed after the cache is gone is shared");
+}
+
+int main() {
+    testArenaAlignment();
+    testArenaReuseAfterRewind();
+    testArenaLargeBlocks();
+    testArenaFinalizers();
+    testArenaAllocator();
+    testSizeClasses();
+    testPoolReuse();
+    testPoolAlignment();
+    testPoolLargeFallback();
+    testPoolAcrossThreads();
+    testPoolAfterThreadCache();
+
+    if (failures == 0) {
+        std::cout << "All allocator tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
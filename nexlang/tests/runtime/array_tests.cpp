@@ -0,0 +1,122 @@
+// Array value tests
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../runtime/array.h"
+#include "../../builtins/builtins_registry.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static Value callBuiltin(const char* name, std::vector<Value> args) {
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    Value result;
+    registry.call(registry.resolve(name), ValueSpan(args.data(), args.size()), result);
+    return result;
+}
+
+static bool getThrows(const Value& array, Value index) {
+    try {
+        callBuiltin("ArrayGet", {array, index});
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// ================= LAYOUTS =================
+static void testFloatLayout() {
+    ArrayRep array;
+    check(array.layout() == ArrayRep::Layout::FLOAT && array.empty(), "new array is an empty FLOAT array");
+    array.appendFloat(3.0);
+    array.appendFloat(-1.5);
+    array.appendFloat(0.25);
+    check(array.layout() == ArrayRep::Layout::FLOAT, "numbers keep the FLOAT layout");
+    check(array.size() == 3 && array.floatData()[1] == -1.5, "elements are contiguous doubles");
+    check(array.toString() == "[3, -1.5, 0.25]", "FLOAT array text");
+}
+
+static void testSwitchToStringLayout() {
+    ArrayRep array;
+    array.appendFloat(1.0);
+    array.appendFloat(0.1);
+    array.appendString("x");
+    array.appendFloat(2.5);
+    check(array.layout() == ArrayRep::Layout::STRING, "first non-number switches to STRING");
+    check(array.size() == 4, "size survives the switch");
+    check(array.stringAt(0) == "1" && array.stringAt(1) == "0.1", "earlier numbers are formatted");
+    check(array.stringAt(2) == "x" && array.stringAt(3) == "2.5", "later elements are strings");
+    check(array.toString() == "[1, 0.1, x, 2.5]", "STRING array text");
+}
+
+static void testStringLayoutEdges() {
+    ArrayRep array;
+    array.appendString("");
+    array.appendString(std::string(1000, 'a'));
+    array.appendString("");
+    check(array.size() == 3, "empty strings are elements");
+    check(array.stringAt(0).empty() && array.stringAt(2).empty(), "empty elements keep their place");
+    check(array.stringAt(1).size() == 1000, "long element");
+}
+
+// ================= VALUES AND BUILTINS =================
+static void testCreateArray() {
+    Value numbers = callBuiltin("Create_Array", {Value(3.0), Value(1.5), Value(2.0)});
+    check(numbers.getType() == ValueType::ARRAY, "Create_Array returns an ARRAY");
+    check(numbers.getArray().layout() == ArrayRep::Layout::FLOAT, "all-number arguments give a FLOAT array");
+    check(numbers.toString() == "[3, 1.5, 2]", "FLOAT array value text");
+
+    Value mixed = callBuiltin("Create_Array", {Value(3.0), Value("1.50"), Value(true)});
+    check(mixed.getArray().layout() == ArrayRep::Layout::STRING, "mixed arguments give a STRING array");
+    check(mixed.toString() == "[3, 1.50, true]", "text is kept as written");
+    check(callBuiltin("ArrayLength", {mixed}).getFloat() == 3.0, "ArrayLength");
+    check(callBuiltin("ArrayLength", {Value("abc")}).getFloat() == 0.0, "ArrayLength of a non-array");
+
+    Value copy = numbers;
+    check(&copy.getArray() == &numbers.getArray(), "copies share the payload");
+}
+
+static void testArrayGet() {
+    Value numbers = callBuiltin("Create_Array", {Value(3.0), Value(1.5)});
+    Value strings = callBuiltin("Create_Array", {Value("a"), Value("b")});
+    Value first = callBuiltin("ArrayGet", {numbers, Value(1.0)});
+    check(first.getType() == ValueType::FLOAT && first.getFloat() == 1.5, "FLOAT element is boxed as FLOAT");
+    Value second = callBuiltin("ArrayGet", {strings, Value(1.0)});
+    check(second.getType() == ValueType::STRING && second.getString() == "b", "STRING element is boxed as STRING");
+    check(callBuiltin("ArrayGet", {numbers, Value("0")}).getFloat() == 3.0, "index given as text");
+    check(callBuiltin("ArrayGet", {numbers, Value(1.9)}).getFloat() == 1.5, "fractional index is truncated");
+}
+
+static void testArrayGetOutOfRange() {
+    Value numbers = callBuiltin("Create_Array", {Value(3.0), Value(1.5)});
+    Value empty = callBuiltin("Create_Array", {});
+    check(getThrows(numbers, Value(2.0)), "index at the size");
+    check(getThrows(numbers, Value(-1.0)), "negative index");
+    check(getThrows(numbers, Value(std::nan(""))), "NaN index");
+    check(getThrows(numbers, Value(1e300)), "huge index");
+    check(getThrows(numbers, Value(std::numeric_limits<double>::infinity())), "infinite index");
+    check(getThrows(empty, Value(0.0)), "any index of an empty array");
+}
+
+int main() {
+    testFloatLayout();
+    testSwitchToStringLayout();
+    testStringLayoutEdges();
+    testCreateArray();
+    testArrayGet();
+    testArrayGetOutOfRange();
+
+    if (failures == 0) {
+        std::cout << "All array tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+// Builtins registry tests
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../builtins/builtins_registry.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static Value callSpan(BuiltinId id, std::vector<Value> args) {
+    Value result;
+    BuiltinsRegistry::getInstance().call(id, ValueSpan(args), result);
+    return result;
+}
+
+// ================= RESOLVE / CALL =================
+static void testResolveAndCall() {
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    const char* names[] = {"Say", "Add", "Concat", "String_Upper", "Create_Array", "Batch_Sum", "Table_GroupBy"};
+    bool resolved = true;
+    for (const char* name : names) {
+        BuiltinId id = registry.resolve(name);
+        resolved &= id != kInvalidBuiltinId && id < registry.size();
+        resolved &= registry.builtin(id).name() == name && registry.builtin(id).id == id;
+        resolved &= registry.getBuiltin(name) == registry.getBuiltinById(id);
+        resolved &= registry.resolve(internString(name)) == id;
+    }
+    check(resolved, "names resolve to their own entries");
+    check(registry.resolve("No_Such_Builtin") == kInvalidBuiltinId && !registry.isBuiltin("No_Such_Builtin"),
+          "unknown name does not resolve");
+    check(registry.getBuiltinById(kInvalidBuiltinId) == nullptr, "invalid id has no entry");
+
+    BuiltinId add = registry.resolve("Add");
+    BuiltinId concat = registry.resolve("Concat");
+    BuiltinId upper = registry.resolve("String_Upper");
+    BuiltinId createArray = registry.resolve("Create_Array");
+    check(callSpan(add, {Value(2.0), Value(3.0)}).getFloat() == 5.0, "Add through its id");
+    check(callSpan(concat, {Value("ab"), Value("cd")}).getString() == "abcd", "Concat through its id");
+    check(callSpan(upper, {Value("mixed")}).getString() == "MIXED", "String_Upper through its id");
+    check(callSpan(createArray, {Value(1.0), Value(2.0), Value(3.0), Value(4.0)}).toString() == "[1, 2, 3, 4]",
+          "variadic builtin through its id");
+    Value array = callSpan(createArray, {Value(1.5), Value(2.5)});
+    check(callSpan(registry.resolve("Batch_Sum"), {array}).getFloat() == 4.0, "result of one call feeds another");
+
+    std::vector<Value> stack = {Value("unrelated"), Value(6.0), Value(7.0)};
+    registry.callOnStack(registry.resolve("Multiply"), stack, 2);
+    check(stack.size() == 2 && stack[1].getFloat() == 42.0 && stack[0].getString() == "unrelated",
+          "call on the stack replaces its arguments");
+}
+
+// ================= FAST ENTRIES =================
+// Result of a call, or the error it raised
+static std::string outcome(const Value& result, const char* error) {
+    if (error) {
+        return std::string("error: ") + error;
+    }
+    std::string text = std::to_string(static_cast<int>(result.getType())) + ":";
+    if (result.getType() == ValueType::ARRAY) {
+        text += std::to_string(static_cast<int>(result.getArray().layout())) + ":";
+    }
+    if (result.getType() != ValueType::HANDLE) {   // every open() is a new handle
+        text += result.toString();
+    }
+    return text;
+}
+
+// Through the span entry, bypassing any fast entry
+static std::string viaSpan(const Builtin& builtin, ValueSpan args, std::string& printed) {
+    std::ostringstream out;
+    std::streambuf* saved = std::cout.rdbuf(out.rdbuf());
+    Value result;
+    std::string text;
+    try {
+        builtin.implementation(args, result);
+        text = outcome(result, nullptr);
+    } catch (const std::exception& error) {
+        text = outcome(result, error.what());
+    }
+    std::cout.rdbuf(saved);
+    printed = out.str();
+    return text;
+}
+
+// Through the fixed-arity overload, which prefers the fast entry
+static std::string viaFixed(BuiltinId id, ValueSpan args, std::string& printed) {
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    std::ostringstream out;
+    std::streambuf* saved = std::cout.rdbuf(out.rdbuf());
+    Value result;
+    std::string text;
+    try {
+        if (args.size() == 1) {
+            registry.call(id, args[0], result);
+        } else if (args.size() == 2) {
+            registry.call(id, args[0], args[1], result);
+        } else {
+            registry.call(id, args[0], args[1], args[2], result);
+        }
+        text = outcome(result, nullptr);
+    } catch (const std::exception& error) {
+        text = outcome(result, error.what());
+    }
+    std::cout.rdbuf(saved);
+    printed = out.str();
+    return text;
+}
+
+static void testFastEntriesMatchSpanEntries() {
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    BuiltinId createArray = registry.resolve("Create_Array");
+    Value numbers = callSpan(createArray, {Value(3.0), Value(1.0), Value(2.0)});
+    Value words = callSpan(createArray, {Value("b"), Value("a,b"), Value("b")});
+    Value mixed = callSpan(createArray, {Value(1.0), Value("x")});
+    Value table = callSpan(registry.resolve("Create_Table"), {Value("n"), numbers, Value("w"), words});
+    const Value samples[] = {Value(), Value(0.0), Value(1.0), Value(-2.5), Value(true), Value("a,b"),
+                             Value("b"), Value("2"), Value("n"), Value("sum"), Value("["), numbers,
+                             words, mixed, table};
+    const size_t count = sizeof(samples) / sizeof(samples[0]);
+
+    size_t mismatches = 0;
+    size_t calls = 0;
+    for (size_t id = 0; id < registry.size(); ++id) {
+        const Builtin& builtin = registry.builtin(static_cast<BuiltinId>(id));
+        if (!builtin.implementation) {
+            continue;   // native plugin builtins have no span entry of their own
+        }
+        for (size_t arity = 1; arity <= 3; ++arity) {
+            if (builtin.argCount >= 0 && static_cast<size_t>(builtin.argCount) != arity) {
+                continue;
+            }
+            size_t combinations = arity == 1 ? count : arity == 2 ? count * count : count * count * count;
+            for (size_t k = 0; k < combinations; ++k) {
+                const Value args[3] = {samples[k % count], samples[k / count % count], samples[k / count / count % count]};
+                std::string spanPrinted;
+                std::string fixedPrinted;
+                std::string spanResult = viaSpan(builtin, ValueSpan(args, arity), spanPrinted);
+                std::string fixedResult = viaFixed(builtin.id, ValueSpan(args, arity), fixedPrinted);
+                if (spanResult != fixedResult || spanPrinted != fixedPrinted) {
+                    std::cerr << builtin.name() << "/" << arity << ": " << spanResult << " vs " << fixedResult
+                              << std::endl;
+                    ++mismatches;
+                }
+                ++calls;
+            }
+        }
+    }
+    check(calls > 0 && mismatches == 0, "fast entries match the span entries");
+}
+
+// ================= SNAPSHOT PUBLICATION =================
+static void testLateRegistration() {
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    BuiltinId add = registry.resolve("Add");
+    size_t startupSize = registry.size();
+    const BuiltinFunction* startupFunctions = registry.functionTable();
+    const Builtin* startupAdd = registry.getBuiltinById(add);
+
+    check(registry.resolve("Test_Late") == kInvalidBuiltinId, "not registered yet");
+    BuiltinId late = registry.registerBuiltin("Test_Late", BuiltinKind::MATH_OP, 1, [](ValueSpan args, Value& result) {
+        result = Value(args[0].toFloat() * 10.0);
+    });
+    check(late == startupSize && registry.size() == startupSize + 1, "new builtin gets the next id");
+    check(registry.resolve("Test_Late") == late && registry.isBuiltin("Test_Late"), "resolve sees the registration");
+    Value result;
+    registry.call(late, Value(4.0), result);
+    check(result.getFloat() == 40.0, "call sees the registration");
+
+    // Readers that loaded the startup table keep using it until reclaim()
+    check(registry.functionTable() != startupFunctions, "registration publishes a new table");
+    check(startupFunctions[add] == registry.functionTable()[add], "old dispatch table is still readable");
+    check(startupAdd->name() == "Add" && startupAdd->id == add, "old builtin entry is still readable");
+
+    BuiltinId replaced = registry.registerBuiltin("Test_Late", BuiltinKind::MATH_OP, 1, [](ValueSpan, Value& result) {
+        result = Value(-1.0);
+    });
+    registry.call(late, Value(4.0), result);
+    check(replaced == late && result.getFloat() == -1.0, "re-registration replaces in place");
+
+    registry.reclaim();
+    registry.call(add, Value(1.0), Value(2.0), result);
+    check(result.getFloat() == 3.0 && registry.resolve("Test_Late") == late, "current table survives reclaim");
+}
+
+int main() {
+    testResolveAndCall();
+    testFastEntriesMatchSpanEntries();
+    testLateRegistration();
+
+    if (failures == 0) {
+        std::cout << "All builtins registry tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// Float formatting and parsing tests
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include "../../runtime/float_ops.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+static bool parsesTo(const char* text, double expected) {
+    std::optional<double> value = parseFloat(text);
+    return value && sameBits(*value, expected);
+}
+
+static bool rejects(const char* text) {
+    return !parseFloat(text).has_value();
+}
+
+// ================= FORMATTING =================
+static void testFormatShortest() {
+    check(floatToString(10.0) == "10", "integral value has no fraction");
+    check(floatToString(-3.0) == "-3", "negative integer");
+    check(floatToString(0.0) == "0", "zero");
+    check(floatToString(-0.0) == "-0", "negative zero keeps its sign");
+    check(floatToString(0.1) == "0.1", "shortest text for 0.1");
+    check(floatToString(0.1 + 0.2) == "0.30000000000000004", "all digits that are needed");
+    check(floatToString(1.5) == "1.5", "exact fraction");
+    check(floatToString(9007199254740993.0) == "9007199254740992", "integer at 2^53");
+}
+
+static void testFormatExponents() {
+    check(floatToString(1e21) == "1e+21", "large power of ten");
+    check(floatToString(1.5e300) == "1.5e+300", "large exponent");
+    check(floatToString(1e-7) == "1e-07", "small exponent");
+    check(floatToString(std::numeric_limits<double>::max()) == "1.7976931348623157e+308", "largest double");
+    check(floatToString(std::numeric_limits<double>::denorm_min()) == "5e-324", "smallest subnormal");
+}
+
+static void testFormatCapacity() {
+    char buffer[kFloatBufferSize];
+    check(formatFloat(-std::numeric_limits<double>::max(), buffer, sizeof(buffer)) == 24, "longest text fits");
+    check(formatFloat(123456.0, buffer, 3) == 0, "too small a buffer");
+    check(formatFloat(0.125, buffer, 2) == 0, "too small a buffer for a fraction");
+}
+
+// ================= PARSING =================
+static void testParseNumbers() {
+    check(parsesTo("42", 42.0), "integer");
+    check(parsesTo("  -2.5\t", -2.5), "surrounding whitespace and sign");
+    check(parsesTo("+7", 7.0), "leading plus");
+    check(parsesTo(".5", 0.5), "no integer digits");
+    check(parsesTo("5.", 5.0), "no fraction digits");
+    check(parsesTo("1e3", 1000.0), "exponent");
+    check(parsesTo("1E-3", 0.001), "negative exponent");
+    check(parsesTo("123456789012345678901234567890", 1.2345678901234568e29), "long mantissa");
+    check(parsesTo("0.1000000000000000055511151231257827", 0.1), "digits past the mantissa");
+    check(parsesTo("0e-999", 0.0), "zero with a huge exponent");
+    check(parsesTo("-0", -0.0), "negative zero");
+}
+
+static void testParseSubnormals() {
+    const double tiny = std::numeric_limits<double>::denorm_min();
+    check(parsesTo("4.9406564584124654e-324", tiny), "smallest subnormal");
+    check(parsesTo("2.4703282292062328e-324", tiny), "halfway above rounds up to the smallest subnormal");
+    check(parsesTo("2.2250738585072009e-308", 2.2250738585072009e-308), "largest subnormal");
+    check(parsesTo("2.2250738585072011e-308", 2.2250738585072009e-308), "rounds down to the largest subnormal");
+    check(parsesTo("2.2250738585072014e-308", std::numeric_limits<double>::min()), "smallest normal");
+    check(parsesTo("1e-320", 9.9998886718268301e-321), "subnormal with few digits");
+    check(parsesTo("0.0000000000000000000001e-300", 9.8813129168249309e-323), "subnormal from fraction digits");
+}
+
+static void testParseOutOfRange() {
+    check(rejects("1e400"), "overflow");
+    check(rejects("-1e400"), "negative overflow");
+    check(rejects("1e-400"), "underflow to zero");
+    check(rejects("2.4703282292062327e-324"), "below half the smallest subnormal");
+}
+
+static void testParseRejectsNonFinite() {
+    check(rejects("inf"), "inf");
+    check(rejects("-inf"), "negative inf");
+    check(rejects("infinity"), "infinity");
+    check(rejects("nan"), "nan");
+    check(rejects("NaN"), "NaN");
+}
+
+static void testParseMalformed() {
+    check(rejects(""), "empty text");
+    check(rejects("   "), "only whitespace");
+    check(rejects("-"), "only a sign");
+    check(rejects("+-1"), "two signs");
+    check(rejects("."), "only a point");
+    check(rejects("1e"), "exponent without digits");
+    check(rejects("1e+"), "signed exponent without digits");
+    check(rejects("10abc"), "numeric prefix");
+    check(rejects("1.2.3"), "two points");
+    check(rejects("0x10"), "hexadecimal");
+    check(rejects("1 2"), "inner whitespace");
+    check(rejects("12345678x"), "non-digit after eight digits");
+}
+
+// ================= ROUND TRIP =================
+static void testRoundTrip() {
+    std::mt19937_64 random(34);
+    char buffer[kFloatBufferSize];
+    size_t mismatches = 0;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t bits = random();
+        if (i % 4 == 0) {
+            bits &= (uint64_t(1) << 52) - 1;   // subnormals
+        }
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        size_t length = formatFloat(value, buffer, sizeof(buffer));
+        std::optional<double> parsed = parseFloat(std::string_view(buffer, length));
+        if (!parsed || !sameBits(*parsed, value)) {
+            ++mismatches;
+        }
+    }
+    check(mismatches == 0, "formatted floats parse back to the same bits");
+
+    const double edges[] = {0.0, -0.0, 1.0, 0.1, 1e22, 1e23, 9007199254740991.0,
+                            std::numeric_limits<double>::min(), std::numeric_limits<double>::max(),
+                            std::numeric_limits<double>::denorm_min()};
+    for (double value : edges) {
+        size_t length = formatFloat(value, buffer, sizeof(buffer));
+        check(parsesTo(std::string(buffer, length).c_str(), value), "edge value round trip");
+    }
+}
+
+int main() {
+    testFormatShortest();
+    testFormatExponents();
+    testFormatCapacity();
+    testParseNumbers();
+    testParseSubnormals();
+    testParseOutOfRange();
+    testParseRejectsNonFinite();
+    testParseMalformed();
+    testRoundTrip();
+
+    if (failures == 0) {
+        std::cout << "All float tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
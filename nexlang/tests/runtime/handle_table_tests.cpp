@@ -0,0 +1,150 @@
+// Handle table tests
+#include <cstdint>
+#include <iostream>
+#include "../../runtime/handle_table.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static int closedCount = 0;
+
+static void countClose(void*) {
+    ++closedCount;
+}
+
+// ================= OPEN AND CLOSE =================
+static void testOpenResolveClose() {
+    HandleTable& table = HandleTable::getInstance();
+    int resource = 7;
+    size_t before = table.liveCount(HandleKind::SOCKET);
+    Handle handle = table.open(HandleKind::SOCKET, &resource);
+    check(handle.valid() && handle.kind == HandleKind::SOCKET, "open returns a valid handle");
+    check(table.resolve(handle) == &resource, "resolve returns the resource");
+    check(table.liveCount(HandleKind::SOCKET) == before + 1, "live count grows");
+    check(table.close(handle), "close a live handle");
+    check(!table.isLive(handle) && table.resolve(handle) == nullptr, "closed handle is stale");
+    check(!table.close(handle), "closing twice fails");
+    check(table.liveCount(HandleKind::SOCKET) == before, "live count shrinks");
+}
+
+static void testDefaultHandleIsInvalid() {
+    Handle none;
+    check(!none.valid(), "default handle is invalid");
+    check(HandleTable::getInstance().resolve(none) == nullptr, "default handle resolves to nothing");
+}
+
+// ================= GENERATIONS =================
+static void testReusedSlotHasNewGeneration() {
+    HandleTable& table = HandleTable::getInstance();
+    int first = 1;
+    int second = 2;
+    Handle old = table.open(HandleKind::TIMER, &first);
+    table.close(old);
+    Handle reused = table.open(HandleKind::TIMER, &second);
+    check(reused.index() == old.index(), "freed slot is reused");
+    check(reused.generation() != old.generation(), "reuse changes the generation");
+    check(table.resolve(old) == nullptr, "stale id does not reach the new resource");
+    check(table.resolve(reused) == &second, "new id resolves");
+    table.close(reused);
+}
+
+static void testGenerationWrapSkipsZero() {
+    // Reaching the wrap through the table would take 2^32 reuses of a slot
+    check(Handle::nextGeneration(1) == 2, "generation counts up");
+    check(Handle::nextGeneration(UINT32_MAX) == 1, "generation wraps around");
+    check(Handle(HandleKind::FILE, 0, 1).valid() && !Handle(HandleKind::FILE, 5, 0).valid(),
+          "generation 0 marks an invalid handle");
+}
+
+static void testStaleHandleAfterManyReuses() {
+    // Past the 4096 reuses after which a 12-bit generation repeated
+    HandleTable& table = HandleTable::getInstance();
+    int first = 1;
+    int current = 2;
+    Handle stale = table.open(HandleKind::BLOCK, &first);
+    Handle handle = stale;
+    bool sameSlot = true;
+    bool staleResolved = false;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        table.close(handle);
+        handle = table.open(HandleKind::BLOCK, &current);
+        sameSlot &= handle.index() == stale.index();
+        staleResolved |= table.resolve(stale) != nullptr;
+    }
+    check(sameSlot, "same slot across reuses");
+    check(!staleResolved && handle.generation() == stale.generation() + 5000, "stale handle never resolves again");
+    check(handle.id() == ((uint64_t(handle.generation()) << Handle::kIndexBits) | handle.index()) &&
+              handle.id() != stale.id(),
+          "id packs the whole generation");
+    table.close(handle);
+}
+
+static void testKindsAreSeparate() {
+    HandleTable& table = HandleTable::getInstance();
+    int resource = 3;
+    Handle file = table.open(HandleKind::FILE, &resource);
+    Handle asSocket(HandleKind::SOCKET, file.index(), file.generation());
+    check(table.resolve(asSocket) != &resource, "an id is only valid for its own kind");
+    table.close(file);
+}
+
+// ================= RELEASE =================
+static void testReleaseCallbacks() {
+    HandleTable& table = HandleTable::getInstance();
+    closedCount = 0;
+    Handle handles[3] = {
+        table.open(HandleKind::FILE, nullptr, &countClose),
+        table.open(HandleKind::SOCKET, nullptr, &countClose),
+        table.open(HandleKind::FILE, nullptr, nullptr),
+    };
+    check(table.release(handles, 3) == 3, "batch release counts live handles");
+    check(closedCount == 2, "release callbacks run once each");
+    check(table.release(handles, 3) == 0, "released handles are stale");
+    check(closedCount == 2, "stale handles do not run callbacks");
+}
+
+static void testHandleScope() {
+    HandleTable& table = HandleTable::getInstance();
+    closedCount = 0;
+    Handle outer;
+    Handle inner;
+    {
+        HandleScope block;
+        outer = table.open(HandleKind::FILE, nullptr, &countClose);
+        {
+            HandleScope nested;
+            inner = table.open(HandleKind::TIMER, nullptr, &countClose);
+        }
+        check(!table.isLive(inner), "nested scope closes its handles");
+        check(table.isLive(outer), "outer handle survives the nested scope");
+        table.close(outer);   // closed early; the scope must not close it again
+    }
+    check(closedCount == 2, "each handle is closed once");
+    check(HandleScope::current() == nullptr, "scopes unwind");
+
+    Handle unscoped = table.open(HandleKind::FILE, nullptr);
+    check(table.isLive(unscoped), "handle opened outside a scope stays open");
+    table.close(unscoped);
+}
+
+int main() {
+    testOpenResolveClose();
+    testDefaultHandleIsInvalid();
+    testReusedSlotHasNewGeneration();
+    testGenerationWrapSkipsZero();
+    testStaleHandleAfterManyReuses();
+    testKindsAreSeparate();
+    testReleaseCallbacks();
+    testHandleScope();
+
+    if (failures == 0) {
+        std::cout << "All handle table tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
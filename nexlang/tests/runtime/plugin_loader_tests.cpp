@@ -0,0 +1,126 @@
+// Native plugin loader tests
+// Usage: plugin_loader_tests <plugin> <plugin needing a newer ABI> <plugin without init>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../builtins/plugin_loader.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static Value callBuiltin(const char* name, std::vector<Value> args) {
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    Value result;
+    registry.call(registry.resolve(name), ValueSpan(args.data(), args.size()), result);
+    return result;
+}
+
+// Message of the error a call raises, or "" if it succeeds
+static std::string callError(const char* name, std::vector<Value> args) {
+    try {
+        callBuiltin(name, std::move(args));
+    } catch (const std::runtime_error& error) {
+        return error.what();
+    }
+    return "";
+}
+
+static std::string loadError(const std::string& path) {
+    try {
+        PluginLoader::getInstance().load(path);
+    } catch (const std::runtime_error& error) {
+        return error.what();
+    }
+    return "";
+}
+
+static bool contains(const std::string& text, const char* part) {
+    return text.find(part) != std::string::npos;
+}
+
+// ================= LOADING =================
+static void testLoad(const std::string& path) {
+    PluginLoader& loader = PluginLoader::getInstance();
+    size_t before = loader.loadedCount();
+    std::vector<std::string> names = loader.load(path);
+    check(loader.loadedCount() == before + 1, "plugin stays loaded");
+    check(names == std::vector<std::string>({"Test_Hypot2", "Test_Square", "Test_Upper", "Test_IsFloat", "Test_Rejected"}),
+          "registered names in order");
+
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    const Builtin* hypot2 = registry.getBuiltin("Test_Hypot2");
+    check(hypot2 && hypot2->kind == BuiltinKind::MATH_OP && hypot2->argCount == 2, "kind and arity");
+    check(callBuiltin("Test_Rejected", {}).getFloat() == 4.0, "invalid descriptors are refused");
+    check(registry.resolve("Test_BadKind") == kInvalidBuiltinId, "refused builtin is not registered");
+}
+
+static void testLoadFailures(const std::string& newerAbiPath, const std::string& noInitPath) {
+    PluginLoader& loader = PluginLoader::getInstance();
+    size_t before = loader.loadedCount();
+    check(contains(loadError("/nonexistent/plugin.so"), "Cannot load plugin '/nonexistent/plugin.so'"),
+          "missing file");
+    check(contains(loadError(noInitPath), "does not export nexlang_plugin_init"), "missing init symbol");
+    check(loader.loadedCount() == before, "failed loads are not kept");
+    check(contains(loadError(newerAbiPath), "failed to initialise"), "plugin rejects an older host ABI");
+    check(loader.loadedCount() == before + 1, "rejecting plugin stays loaded");
+}
+
+static void testLoadFromEnvironment(const std::string& path) {
+    PluginLoader& loader = PluginLoader::getInstance();
+    size_t before = loader.loadedCount();
+    unsetenv("NEXLANG_PLUGINS");
+    loader.loadFromEnvironment();
+    check(loader.loadedCount() == before, "no variable, no plugins");
+    setenv("NEXLANG_PLUGINS", ("::" + path + ":").c_str(), 1);
+    loader.loadFromEnvironment();
+    check(loader.loadedCount() == before + 1, "empty list entries are skipped");
+    unsetenv("NEXLANG_PLUGINS");
+}
+
+// ================= CALLS =================
+static void testCalls() {
+    check(callBuiltin("Test_Hypot2", {Value(3.0), Value("4")}).getFloat() == 25.0, "float arguments");
+    check(callBuiltin("Test_Upper", {Value("mixed Case 1")}).getString() == "MIXED CASE 1", "string result");
+    check(callBuiltin("Test_IsFloat", {Value(1.0)}).getBool(), "value type is FLOAT");
+    check(!callBuiltin("Test_IsFloat", {Value("1")}).getBool(), "value type is STRING");
+
+    Value numbers = callBuiltin("Create_Array", {Value(1.0), Value(-2.0), Value(3.0)});
+    Value squares = callBuiltin("Test_Square", {numbers});
+    check(squares.getType() == ValueType::ARRAY && squares.getArray().layout() == ArrayRep::Layout::FLOAT,
+          "array result is a FLOAT array");
+    check(squares.toString() == "[1, 4, 9]", "array result");
+}
+
+static void testCallErrors() {
+    check(callError("Test_Hypot2", {Value(1.0)}) == "Test_Hypot2: need 2 arguments", "raised error names the builtin");
+    check(callError("Test_Hypot2", {Value(1.0), Value(2.0)}).empty(), "error does not leak into the next call");
+    Value strings = callBuiltin("Create_Array", {Value("a")});
+    check(callError("Test_Square", {strings}) == "Test_Square: not a FLOAT array", "STRING array is not float data");
+    check(callError("Test_Upper", {Value(1.0)}) == "Test_Upper: need a short STRING", "non-string has no text");
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::cerr << "usage: plugin_loader_tests <plugin> <newer-abi plugin> <no-init plugin>" << std::endl;
+        return 1;
+    }
+    testLoad(argv[1]);
+    testLoadFailures(argv[2], argv[3]);
+    testLoadFromEnvironment(argv[1]);
+    testCalls();
+    testCallErrors();
+
+    if (failures == 0) {
+        std::cout << "All plugin loader tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+// Regex engine tests
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../runtime/regex.h"
+#include "../../builtins/builtins_registry.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+// Bounds of the first match as "begin,end", or "none"
+static std::string searchBounds(const char* pattern, std::string_view text, size_t from = 0) {
+    Regex re(pattern);
+    RegexMatch match;
+    if (!re.search(text, from, match)) {
+        return "none";
+    }
+    return std::to_string(match.begin) + "," + std::to_string(match.end);
+}
+
+static Value callBuiltin(const char* name, std::vector<Value> args) {
+    BuiltinsRegistry& registry = BuiltinsRegistry::getInstance();
+    Value result;
+    registry.call(registry.resolve(name), ValueSpan(args.data(), args.size()), result);
+    return result;
+}
+
+static bool compileThrows(const char* pattern) {
+    try {
+        Regex re(pattern);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// ================= MATCHES =================
+static void testMatches() {
+    Regex digits("\\d+(\\.\\d+)?");
+    check(digits.matches("42"), "integer");
+    check(digits.matches("3.14"), "decimal");
+    check(!digits.matches("3."), "incomplete decimal");
+    check(!digits.matches(""), "empty text");
+
+    Regex word("[a-z]{2,3}");
+    check(!word.matches("a") && word.matches("ab") && word.matches("abc") && !word.matches("abcd"),
+          "bounded repetition");
+    check(Regex("(?:ab|cd)*").matches(""), "star matches empty text");
+    check(Regex("[^0-9]+").matches("x-y"), "negated set");
+    check(Regex("a\\.b").matches("a.b") && !Regex("a\\.b").matches("axb"), "escaped dot");
+    check(Regex("^abc$").matches("abc"), "anchors around a full match");
+    check(Regex("$").matches("") && !Regex("$").matches("a"), "lone end anchor");
+}
+
+static void testPathologicalPatterns() {
+    std::string as(5000, 'a');
+    check(!Regex("(a*)*b").matches(as), "nested star without backtracking");
+    check(!Regex("(a|aa)*c").matches(as), "ambiguous alternation without backtracking");
+    RegexMatch match;
+    check(!Regex("(a*)*b").search(as, 0, match), "nested star search");
+}
+
+// ================= SEARCH =================
+static void testSearch() {
+    check(searchBounds("b+", "aabbbc") == "2,5", "leftmost-longest");
+    check(searchBounds("a|ab", "xab") == "1,3", "longest alternative");
+    check(searchBounds("ERROR: \\d+", "....ERROR: 42 ok") == "4,13", "literal prefix");
+    check(searchBounds("b", "abab", 2) == "3,4", "search from an offset");
+    check(searchBounds("z", "abc") == "none", "no match");
+    check(searchBounds("^b", "ab") == "none", "start anchor is not a line start");
+}
+
+static void testSearchAnchorsAndEmptyMatches() {
+    check(searchBounds("$", "abc") == "3,3", "end anchor matches at the end");
+    check(searchBounds("()$", "abc") == "3,3", "group before the end anchor");
+    check(searchBounds("($)", "abc") == "3,3", "end anchor inside a group");
+    check(searchBounds("c$", "abcabc") == "5,6", "literal before the end anchor");
+    check(searchBounds("x*", "abc") == "0,0", "empty match at the start");
+    check(searchBounds("x*", "abc", 3) == "3,3", "empty match at the end");
+    check(searchBounds("^", "abc") == "0,0", "start anchor");
+    check(searchBounds("b*$", "abb") == "1,3", "longest match before the end anchor");
+    check(callBuiltin("Regex_Search", {Value("abc"), Value("$")}).getFloat() == 3.0, "Regex_Search end anchor");
+    check(callBuiltin("Regex_Search", {Value("abc"), Value("d")}).getFloat() == -1.0, "Regex_Search no match");
+}
+
+// ================= REPLACE AND SPLIT =================
+static void testReplace() {
+    check(callBuiltin("Regex_Replace", {Value("a1b22c"), Value("\\d+"), Value("#")}).getString() == "a#b#c",
+          "replace every match");
+    check(callBuiltin("Regex_Replace", {Value("abc"), Value("$"), Value("!")}).getString() == "abc!",
+          "replace at the end anchor");
+    check(callBuiltin("Regex_Replace", {Value("abc"), Value("^"), Value(">")}).getString() == ">abc",
+          "replace at the start anchor");
+    check(callBuiltin("Regex_Replace", {Value("abc"), Value("x*"), Value("-")}).getString() == "-a-b-c-",
+          "empty matches at every position");
+    check(callBuiltin("Regex_Replace", {Value("abc"), Value("z"), Value("-")}).getString() == "abc",
+          "no match leaves the text");
+}
+
+static void testSplit() {
+    check(callBuiltin("Regex_Split", {Value("a, b,c"), Value(", *")}).toString() == "[a, b, c]",
+          "split on a separator");
+    check(callBuiltin("Regex_Split", {Value(",a,"), Value(",")}).toString() == "[, a, ]",
+          "separators at both ends");
+    check(callBuiltin("Regex_Split", {Value("abc"), Value("")}).toString() == "[, a, b, c, ]",
+          "split on empty matches");
+    check(callBuiltin("Regex_Split", {Value("abc"), Value("$")}).toString() == "[abc, ]",
+          "split at the end anchor");
+    check(callBuiltin("Regex_Split", {Value("abc"), Value("z")}).toString() == "[abc]",
+          "no match yields the whole text");
+}
+
+// ================= ERRORS AND CACHE =================
+static void testMalformedPatterns() {
+    check(compileThrows("a(b"), "unbalanced group");
+    check(compileThrows("*a"), "repetition of nothing");
+    check(compileThrows("[a-"), "unterminated set");
+}
+
+static void testPatternCache() {
+    RegexCache& cache = RegexCache::forThread();
+    for (int i = 0; i < 200; ++i) {
+        cache.get("p" + std::to_string(i % 70));
+    }
+    check(cache.size() == RegexCache::kCapacity, "cache is bounded");
+    check(&cache.get("p69") == &cache.get("p69"), "hit returns the cached regex");
+}
+
+int main() {
+    testMatches();
+    testPathologicalPatterns();
+    testSearch();
+    testSearchAnchorsAndEmptyMatches();
+    testReplace();
+    testSplit();
+    testMalformedPatterns();
+    testPatternCache();
+
+    if (failures == 0) {
+        std::cout << "All regex tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
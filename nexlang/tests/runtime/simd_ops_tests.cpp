@@ -0,0 +1,132 @@
+// SIMD kernel tests
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../../runtime/simd_ops.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static const size_t kLengths[] = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100, 1001};
+
+// Sentinel written past the end of every output
+static const double kGuard = 12345.0;
+
+static bool nearlyEqual(double a, double b, double scale) {
+    return std::fabs(a - b) <= 1e-12 * scale;
+}
+
+// Inputs start one element into their buffers, so vector loads are unaligned
+struct Inputs {
+    std::vector<double> a, b, c;
+
+    Inputs(size_t n, std::mt19937& random) : a(n + 1), b(n + 1), c(n + 1) {
+        std::uniform_real_distribution<double> dist(-100.0, 100.0);
+        for (size_t i = 1; i <= n; ++i) {
+            a[i] = dist(random);
+            b[i] = i % 3 == 0 ? a[i] : dist(random);   // some equal pairs for EQUAL
+            c[i] = dist(random);
+        }
+    }
+};
+
+// ================= ELEMENT-WISE =================
+static void testElementWise(const SimdKernels& kernels, const SimdKernels& scalar) {
+    std::mt19937 random(43);
+    for (size_t n : kLengths) {
+        Inputs in(n, random);
+        const double* a = in.a.data() + 1;
+        const double* b = in.b.data() + 1;
+        const double* c = in.c.data() + 1;
+        std::vector<double> out(n + 2, kGuard);
+        std::vector<double> expected(n);
+
+        kernels.add(a, b, out.data() + 1, n);
+        scalar.add(a, b, expected.data(), n);
+        check(std::equal(expected.begin(), expected.end(), out.begin() + 1), "add matches scalar");
+
+        kernels.mul(a, b, out.data() + 1, n);
+        scalar.mul(a, b, expected.data(), n);
+        check(std::equal(expected.begin(), expected.end(), out.begin() + 1), "mul matches scalar");
+
+        // Every kernel rounds the multiply-add once
+        kernels.fma(a, b, c, out.data() + 1, n);
+        scalar.fma(a, b, c, expected.data(), n);
+        check(std::equal(expected.begin(), expected.end(), out.begin() + 1), "fma matches scalar");
+
+        for (CompareOp op : {CompareOp::LESS, CompareOp::EQUAL, CompareOp::GREATER}) {
+            kernels.compare(a, b, out.data() + 1, n, op);
+            scalar.compare(a, b, expected.data(), n, op);
+            check(std::equal(expected.begin(), expected.end(), out.begin() + 1), "compare matches scalar");
+        }
+        check(out[0] == kGuard && out[n + 1] == kGuard, "nothing is written outside the output");
+    }
+}
+
+static void testAliasedOutput(const SimdKernels& kernels) {
+    std::mt19937 random(44);
+    for (size_t n : kLengths) {
+        Inputs in(n, random);
+        std::vector<double> expected(n);
+        for (size_t i = 0; i < n; ++i) {
+            expected[i] = in.a[i + 1] + in.b[i + 1];
+        }
+        kernels.add(in.a.data() + 1, in.b.data() + 1, in.a.data() + 1, n);
+        check(std::equal(expected.begin(), expected.end(), in.a.begin() + 1), "output may alias an input");
+    }
+}
+
+// ================= REDUCTIONS =================
+static void testReductions(const SimdKernels& kernels, const SimdKernels& scalar) {
+    std::mt19937 random(45);
+    for (size_t n : kLengths) {
+        Inputs in(n, random);
+        const double* a = in.a.data() + 1;
+        const double* b = in.b.data() + 1;
+        // Lane-wise partial sums may differ from a strict left-to-right sum
+        check(nearlyEqual(kernels.sum(a, n), scalar.sum(a, n), 100.0 * n), "sum matches scalar");
+        check(nearlyEqual(kernels.dot(a, b, n), scalar.dot(a, b, n), 1e4 * n), "dot matches scalar");
+        check(kernels.min(a, n) == scalar.min(a, n), "min matches scalar");
+        check(kernels.max(a, n) == scalar.max(a, n), "max matches scalar");
+    }
+    check(kernels.sum(nullptr, 0) == 0.0 && kernels.dot(nullptr, nullptr, 0) == 0.0, "empty reductions");
+
+    // Extremes in the remainder that the vector loop does not cover
+    std::vector<double> values(19, 1.0);
+    values[18] = -7.0;
+    values[17] = 9.0;
+    check(kernels.min(values.data(), values.size()) == -7.0, "min in the last element");
+    check(kernels.max(values.data(), values.size()) == 9.0, "max in the remainder");
+}
+
+// ================= DISPATCH =================
+static void testDispatch() {
+    check(&simdKernels() == &simdKernels(simdLevel()), "running CPU uses its own level");
+    const SimdKernels& scalar = simdKernels(SimdLevel::SCALAR);
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (static_cast<int>(level) > static_cast<int>(simdLevel())) {
+            continue;   // not supported by this CPU
+        }
+        const SimdKernels& kernels = simdKernels(level);
+        testElementWise(kernels, scalar);
+        testAliasedOutput(kernels);
+        testReductions(kernels, scalar);
+    }
+}
+
+int main() {
+    testDispatch();
+
+    if (failures == 0) {
+        std::cout << "All SIMD tests passed (level " << static_cast<int>(simdLevel()) << ")" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
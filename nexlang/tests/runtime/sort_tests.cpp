@@ -0,0 +1,232 @@
+// Sort and thread pool tests. NEXLANG_THREADS is set before the pool is
+// first used, so the parallel sort and merge run on several threads even
+// on a single-core machine.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../runtime/sort.h"
+#include "../../runtime/thread_pool.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static const size_t kPoolThreads = 4;
+
+// Below the radix minimum, at the parallel threshold, and large enough for
+// one chunk per pool thread (with a remainder)
+static const size_t kSizes[] = {0, 1, 2, 50, 1000, kParallelSortThreshold - 1, kParallelSortThreshold,
+                                kParallelSortThreshold * 4 + 7};
+
+static bool sameBits(double a, double b) {
+    return floatSortKey(a) == floatSortKey(b);
+}
+
+// Inputs of a few shapes: random, few distinct values, sorted, reversed
+static std::vector<double> floatInput(size_t n, int shape, std::mt19937_64& random) {
+    std::vector<double> values(n);
+    for (size_t i = 0; i < n; ++i) {
+        switch (shape) {
+            case 0: values[i] = std::uniform_real_distribution<double>(-1e6, 1e6)(random); break;
+            case 1: values[i] = static_cast<double>(random() % 10) - 5.0; break;
+            case 2: values[i] = static_cast<double>(i); break;
+            default: values[i] = static_cast<double>(n - i); break;
+        }
+    }
+    return values;
+}
+
+// ================= THREAD POOL =================
+static void testThreadPool() {
+    ThreadPool& pool = ThreadPool::getInstance();
+    check(pool.concurrency() == kPoolThreads, "NEXLANG_THREADS sets the pool size");
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.run(hits.size(), [&](size_t i) { hits[i].fetch_add(1); });
+    check(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h.load() == 1; }),
+          "every task runs once");
+
+    std::atomic<size_t> inner{0};
+    pool.run(8, [&](size_t) {
+        pool.run(8, [&](size_t) { inner.fetch_add(1); });
+    });
+    check(inner.load() == 64, "tasks may run nested batches");
+
+    bool rethrown = false;
+    std::atomic<size_t> finished{0};
+    try {
+        pool.run(16, [&](size_t i) {
+            finished.fetch_add(1);
+            if (i == 5) throw std::runtime_error("task failed");
+        });
+    } catch (const std::runtime_error&) {
+        rethrown = true;
+    }
+    check(rethrown && finished.load() == 16, "task error is rethrown after the batch");
+}
+
+// ================= FLOATS =================
+static void testSortFloats() {
+    std::mt19937_64 random(49);
+    for (size_t n : kSizes) {
+        for (int shape = 0; shape < 4; ++shape) {
+            std::vector<double> values = floatInput(n, shape, random);
+            std::vector<double> expected = values;
+            std::sort(expected.begin(), expected.end());
+            sortFloats(values.data(), n);
+            check(values == expected, "sortFloats matches std::sort");
+        }
+    }
+}
+
+static void testFloatOrder() {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> values = {3.0, -nan, 0.0, -inf, nan, -0.0, inf, -2.5,
+                                  std::numeric_limits<double>::denorm_min()};
+    sortFloats(values.data(), values.size());
+    check(std::isnan(values[0]) && std::signbit(values[0]), "negative NaN first");
+    check(values[1] == -inf && values[2] == -2.5, "negative numbers ascending");
+    check(values[3] == 0.0 && std::signbit(values[3]) && !std::signbit(values[4]), "-0 before +0");
+    check(values[5] == std::numeric_limits<double>::denorm_min() && values[6] == 3.0 && values[7] == inf,
+          "positive numbers ascending");
+    check(std::isnan(values[8]) && !std::signbit(values[8]), "positive NaN last");
+
+    bool roundTrip = true;
+    for (double value : {0.0, -0.0, 1.5, -1e300, inf, -inf}) {
+        roundTrip &= sameBits(floatFromSortKey(floatSortKey(value)), value);
+    }
+    check(roundTrip, "sort keys map back to the same bits");
+}
+
+static void testSortFloatEntries() {
+    std::mt19937_64 random(50);
+    for (size_t n : kSizes) {
+        std::vector<FloatSortEntry> entries(n);
+        for (size_t i = 0; i < n; ++i) {
+            entries[i] = {floatSortKey(static_cast<double>(random() % 50)), i};
+        }
+        std::vector<FloatSortEntry> expected = entries;
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const FloatSortEntry& a, const FloatSortEntry& b) { return a.key < b.key; });
+        sortFloatEntries(entries.data(), n);
+        bool same = true;
+        for (size_t i = 0; i < n; ++i) {
+            same &= entries[i].index == expected[i].index;
+        }
+        check(same, "float entries keep equal keys in input order");
+    }
+}
+
+// ================= STRINGS =================
+static void testSortStrings() {
+    std::mt19937_64 random(51);
+    for (size_t n : kSizes) {
+        std::vector<std::string> texts(n);
+        for (std::string& text : texts) {
+            text = std::to_string(random() % 997);
+        }
+        std::vector<std::string_view> views(texts.begin(), texts.end());
+        std::vector<std::string_view> expected = views;
+        std::sort(expected.begin(), expected.end());
+        sortStrings(views.data(), n);
+        check(views == expected, "sortStrings matches std::sort");
+
+        std::vector<StringSortEntry> entries(n);
+        for (size_t i = 0; i < n; ++i) {
+            entries[i] = {texts[i], i};
+        }
+        std::vector<StringSortEntry> stable = entries;
+        std::stable_sort(stable.begin(), stable.end(),
+                         [](const StringSortEntry& a, const StringSortEntry& b) { return a.key < b.key; });
+        std::vector<StringSortEntry> unstable = entries;
+        sortStringEntries(entries.data(), n, true);
+        sortStringEntries(unstable.data(), n, false);
+        bool sameOrder = true;
+        bool sameKeys = true;
+        for (size_t i = 0; i < n; ++i) {
+            sameOrder &= entries[i].index == stable[i].index;
+            sameKeys &= unstable[i].key == stable[i].key;
+        }
+        check(sameOrder, "stable string entries keep equal keys in input order");
+        check(sameKeys, "unstable string entries are sorted");
+    }
+}
+
+// ================= PDQSORT =================
+static void testPdqSortPatterns() {
+    const size_t n = 200000;
+    std::vector<uint64_t> values(n);
+    std::vector<std::vector<uint64_t>> inputs;
+    for (size_t i = 0; i < n; ++i) values[i] = i < n / 2 ? i : n - i;   // organ pipe
+    inputs.push_back(values);
+    for (size_t i = 0; i < n; ++i) values[i] = i % 1000;                // sawtooth
+    inputs.push_back(values);
+    for (size_t i = 0; i < n; ++i) values[i] = 7;                       // all equal
+    inputs.push_back(values);
+    for (size_t i = 0; i < n; ++i) values[i] = n - i;                   // descending
+    inputs.push_back(values);
+    for (size_t i = 0; i < n; ++i) values[i] = i ^ 1;                   // nearly sorted
+    inputs.push_back(values);
+    for (std::vector<uint64_t>& input : inputs) {
+        std::vector<uint64_t> expected = input;
+        std::sort(expected.begin(), expected.end());
+        pdqSort(input.data(), input.data() + n, std::less<uint64_t>());
+        check(input == expected, "pdqSort on an adversarial pattern");
+    }
+
+    std::vector<int> descending = {5, 4, 3, 2, 1};
+    pdqSort(descending.data(), descending.data() + descending.size(), std::greater<int>());
+    check(descending == std::vector<int>({5, 4, 3, 2, 1}), "custom comparison");
+}
+
+// ================= TOP K =================
+static void testTopK() {
+    std::mt19937_64 random(52);
+    for (size_t n : {size_t(0), size_t(1), size_t(100), kParallelSortThreshold + 3}) {
+        std::vector<double> values = floatInput(n, 0, random);
+        std::vector<double> expected = values;
+        std::sort(expected.begin(), expected.end(), std::greater<double>());
+        for (size_t k : {size_t(0), size_t(1), size_t(10), n / 2, n, n + 5}) {
+            std::vector<double> top = values;
+            topFloats(top.data(), n, k);
+            size_t count = std::min(k, n);
+            check(std::equal(top.begin(), top.begin() + count, expected.begin()), "topFloats largest first");
+        }
+    }
+
+    std::vector<std::string_view> words = {"pear", "apple", "fig", "plum", "kiwi"};
+    topStrings(words.data(), words.size(), 2);
+    check(words[0] == "plum" && words[1] == "pear", "topStrings largest first");
+}
+
+int main() {
+    setenv("NEXLANG_THREADS", std::to_string(kPoolThreads).c_str(), 1);
+
+    testThreadPool();
+    testSortFloats();
+    testFloatOrder();
+    testSortFloatEntries();
+    testSortStrings();
+    testPdqSortPatterns();
+    testTopK();
+
+    if (failures == 0) {
+        std::cout << "All sort tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
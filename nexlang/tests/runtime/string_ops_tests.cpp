@@ -0,0 +1,234 @@
+// String operation tests, checked against std::string_view. The same file is
+// built twice: once with the SSE2 scans and once with NEXLANG_SCALAR_STRINGS.
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../runtime/string_ops.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+// Random text over a small alphabet, so needles are found often. Lengths
+// run past several 16-byte blocks to reach every tail size.
+static std::string randomText(std::mt19937& random, size_t maxLength, const char* alphabet) {
+    std::string_view letters(alphabet);
+    std::string text(random() % (maxLength + 1), ' ');
+    for (char& c : text) {
+        c = letters[random() % letters.size()];
+    }
+    return text;
+}
+
+static const char kAlphabet[] = "abcAZ \t\n\xc3\xa9";
+
+// ================= REFERENCES =================
+static size_t referenceCount(std::string_view text, std::string_view needle) {
+    size_t count = 0;
+    for (size_t at = text.find(needle); at != std::string_view::npos; at = text.find(needle, at + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+static std::string referenceReplace(std::string_view text, std::string_view needle, std::string_view replacement) {
+    std::string result;
+    size_t last = 0;
+    for (size_t at = text.find(needle); at != std::string_view::npos; at = text.find(needle, at + needle.size())) {
+        result.append(text.substr(last, at - last));
+        result.append(replacement);
+        last = at + needle.size();
+    }
+    result.append(text.substr(last));
+    return result;
+}
+
+static std::vector<std::string_view> referenceSplit(std::string_view text, std::string_view delimiter) {
+    std::vector<std::string_view> pieces;
+    size_t start = 0;
+    for (size_t at = text.find(delimiter); at != std::string_view::npos; at = text.find(delimiter, start)) {
+        pieces.push_back(text.substr(start, at - start));
+        start = at + delimiter.size();
+    }
+    pieces.push_back(text.substr(start));
+    return pieces;
+}
+
+// Decodes every code point and checks its range
+static bool referenceValidUtf8(std::string_view text, size_t& codePoints) {
+    codePoints = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1 : lead >> 5 == 0x6 ? 2 : lead >> 4 == 0xE ? 3 : lead >> 3 == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size()) {
+            return false;
+        }
+        uint32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+        for (size_t k = 1; k < length; ++k) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                return false;
+            }
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        static const uint32_t kMinimum[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < kMinimum[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return false;
+        }
+        i += length;
+        ++codePoints;
+    }
+    return true;
+}
+
+// ================= SEARCH =================
+static void testFind() {
+    std::mt19937 random(48);
+    size_t mismatches = 0;
+    for (int i = 0; i < 50000; ++i) {
+        std::string text = randomText(random, 70, kAlphabet);
+        std::string needle = randomText(random, 3, "abc");
+        size_t from = random() % (text.size() + 3);
+        std::string_view view(text);
+        mismatches += findString(text, needle, from) != view.find(needle, from);
+        mismatches += findByte(text, 'A', from) != view.find('A', from);
+        mismatches += containsString(text, needle) != (view.find(needle) != std::string_view::npos);
+        mismatches += countString(text, needle) != (needle.empty() ? 0 : referenceCount(text, needle));
+    }
+    check(mismatches == 0, "search matches std::string_view");
+
+    // A match in every position across block boundaries
+    std::string text(100, '.');
+    bool allFound = true;
+    for (size_t at = 0; at + 2 <= text.size(); ++at) {
+        text[at] = 'x';
+        text[at + 1] = 'y';
+        allFound &= findString(text, "xy") == at && findByte(text, 'y') == at + 1;
+        text[at] = '.';
+        text[at + 1] = '.';
+    }
+    check(allFound, "match at every offset");
+    check(findString("abc", "", 3) == 3 && findString("abc", "", 4) == kNotFound, "empty needle");
+    check(findByte("", 'a') == kNotFound, "empty text");
+    check(findByte(std::string(33, '\xff'), '\xff', 32) == 32, "high byte in the tail");
+}
+
+// ================= REPLACE / SPLIT =================
+static void testReplaceAndSplit() {
+    std::mt19937 random(49);
+    size_t mismatches = 0;
+    for (int i = 0; i < 50000; ++i) {
+        std::string text = randomText(random, 70, kAlphabet);
+        std::string needle = randomText(random, 3, "abc");
+        if (needle.empty()) {
+            needle = "a";
+        }
+        std::string replacement = randomText(random, 4, "XY");
+        std::string expected = referenceReplace(text, needle, replacement);
+        std::string out(replaceAllSize(text, needle, replacement), '?');
+        mismatches += replaceAll(text, needle, replacement, &out[0]) != out.size();
+        mismatches += out != expected;
+
+        std::vector<std::string_view> pieces;
+        splitString(text, needle, pieces);
+        mismatches += pieces != referenceSplit(text, needle);
+    }
+    check(mismatches == 0, "replace and split match the reference");
+
+    std::string unchanged(replaceAllSize("abc", "", "X"), '?');
+    replaceAll("abc", "", "X", &unchanged[0]);
+    check(unchanged == "abc", "empty needle replaces nothing");
+    std::vector<std::string_view> pieces;
+    splitString("a,b", "", pieces);
+    check(pieces.size() == 1 && pieces[0] == "a,b", "empty delimiter keeps the whole text");
+    pieces.clear();
+    splitString(",,", ",", pieces);
+    check(pieces.size() == 3 && pieces[1].empty(), "empty pieces between delimiters");
+}
+
+// ================= CASE / WHITESPACE =================
+static void testCase() {
+    // Every byte value, at every offset within a block
+    std::string all;
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        for (int b = 0; b < 256; ++b) {
+            all.push_back(static_cast<char>(b));
+        }
+    }
+    bool upperOk = true;
+    bool lowerOk = true;
+    for (size_t start = 0; start < 17; ++start) {
+        std::string_view in(all.data() + start, all.size() - start - 5);
+        std::string upper(in.size(), '\0');
+        std::string lower(in);
+        toUpperAscii(in.data(), in.size(), &upper[0]);
+        toLowerAscii(lower.data(), lower.size(), &lower[0]);   // in place
+        for (size_t i = 0; i < in.size(); ++i) {
+            char c = in[i];
+            upperOk &= upper[i] == (c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+            lowerOk &= lower[i] == (c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+        }
+    }
+    check(upperOk, "upper-case only changes ASCII letters");
+    check(lowerOk, "lower-case in place");
+}
+
+static void testTrim() {
+    check(trimAscii("  \t hi there \n") == "hi there", "both ends");
+    check(trimAscii(" \t\n\v\f\r").empty(), "only whitespace");
+    check(trimAscii("").empty(), "empty text");
+    check(trimAscii("\xc2\xa0x\xc2\xa0") == "\xc2\xa0x\xc2\xa0", "non-ASCII space is kept");
+    std::string padded = std::string(20, ' ') + "x" + std::string(20, '\t');
+    check(trimAscii(padded) == "x", "runs longer than a block");
+}
+
+// ================= UTF-8 =================
+static void testUtf8() {
+    check(validUtf8("h\xc3\xa9llo w\xe2\x82\xac rld \xf0\x9f\x98\x80 and some more ascii text"), "mixed widths");
+    check(!validUtf8("padding padding \xc0\xaf"), "overlong after an ASCII block");
+    check(!validUtf8("\xed\xa0\x80 surrogate"), "surrogate");
+    check(!validUtf8("\xf4\x90\x80\x80"), "past U+10FFFF");
+    check(!validUtf8("sixteen bytes ok\xe2\x82"), "truncated at the end of a block");
+    check(validUtf8(std::string(64, 'a')) && utf8Length(std::string(64, 'a')) == 64, "ASCII blocks");
+
+    std::mt19937 random(50);
+    size_t mismatches = 0;
+    const char* pieces[] = {"a", "bc", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xed\x9f\xbf", "\xef\xbf\xbf"};
+    for (int i = 0; i < 50000; ++i) {
+        std::string text;
+        size_t count = random() % 24;
+        for (size_t k = 0; k < count; ++k) {
+            text += pieces[random() % 7];
+        }
+        if (random() % 2 && !text.empty()) {
+            text[random() % text.size()] = static_cast<char>(random());   // maybe break it
+        }
+        size_t codePoints;
+        bool valid = referenceValidUtf8(text, codePoints);
+        mismatches += validUtf8(text) != valid;
+        mismatches += valid && utf8Length(text) != codePoints;
+    }
+    check(mismatches == 0, "UTF-8 checks match a decoder");
+}
+
+int main() {
+    testFind();
+    testReplaceAndSplit();
+    testCase();
+    testTrim();
+    testUtf8();
+
+    if (failures == 0) {
+        std::cout << "All string tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Columnar table tests
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "../../runtime/table.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static std::unique_ptr<TableRep> parse(const std::string& csv) {
+    return std::unique_ptr<TableRep>(tableFromCsv(csv));
+}
+
+static bool csvThrows(const std::string& csv) {
+    try {
+        parse(csv);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// ================= CSV =================
+static void testCsvPlainFields() {
+    auto table = parse("name,amount\r\neast,10\nwest,5.5\n\nnorth,\n");
+    check(table->rows == 3, "blank lines are skipped");
+    check(table->names.size() == 2 && table->names[1] == "amount", "header names");
+    const Column& amount = table->column("amount");
+    check(amount.type == Column::Type::FLOAT, "numeric column is FLOAT");
+    check(amount.numbers[1] == 5.5, "CRLF and LF line endings");
+    check(amount.isNull(2) && !amount.isNull(0), "empty field is null");
+    check(table->column("name").type == Column::Type::STRING, "text column is STRING");
+}
+
+static void testCsvQuotedFields() {
+    auto table = parse("a,b\n\"Smith, J\",\"x\"\n\"\",\"line\nbreak\"\n");
+    const Column& a = table->column("a");
+    check(a.stringAt(0) == "Smith, J", "quoted field keeps its comma");
+    check(a.isNull(1), "empty quoted field is null");
+    check(table->column("b").stringAt(1) == "line\nbreak", "quoted field keeps its line break");
+}
+
+static void testCsvEscapedFields() {
+    // Every field of a record is unescaped, so each needs its own storage
+    auto table = parse("x,y,z\n\"a\"\"b\",\"c\"\"d\",\"e\"\"f\"\n\"\"\"\",plain,\"say \"\"hi\"\"\"\n");
+    check(table->rows == 2, "escaped records");
+    check(table->column("x").stringAt(0) == "a\"b", "first escaped field");
+    check(table->column("y").stringAt(0) == "c\"d", "second escaped field");
+    check(table->column("z").stringAt(0) == "e\"f", "third escaped field");
+    check(table->column("x").stringAt(1) == "\"", "field holding only a quote");
+    check(table->column("z").stringAt(1) == "say \"hi\"", "escapes at the end of a field");
+    check(table->toString() == "x,y,z\n\"a\"\"b\",\"c\"\"d\",\"e\"\"f\"\n\"\"\"\",plain,\"say \"\"hi\"\"\"\n",
+          "escaped fields round-trip");
+}
+
+static void testCsvLongEscapedFields() {
+    std::string longText(100, 'q');
+    auto table = parse("a,b,c,d\n\"" + longText + "\"\"\",\"1\"\"\",\"" + longText + "\"\"\",\"2\"\"\"\n");
+    check(table->column("a").stringAt(0) == longText + "\"", "long escaped field");
+    check(table->column("b").stringAt(0) == "1\"", "short escaped field after a long one");
+    check(table->column("d").stringAt(0) == "2\"", "last escaped field");
+}
+
+static void testCsvMissingTrailingFields() {
+    auto table = parse("a,b,c\n1\n2,x,3\n");
+    check(table->rows == 2, "short record is kept");
+    check(table->column("b").isNull(0) && table->column("c").isNull(0), "missing fields are nulls");
+    check(table->column("c").numbers[1] == 3.0, "full record after a short one");
+}
+
+static void testCsvErrors() {
+    check(csvThrows("a,b\n\"open,1\n"), "unterminated quote");
+    check(csvThrows("a\n\"x\"y\n"), "text after a closing quote");
+    check(csvThrows("a\n1,2\n"), "more fields than the header");
+}
+
+// ================= OPERATIONS =================
+static void testFilterAndAggregate() {
+    auto table = parse("region,amount\neast,10\nwest,5.5\neast,\nnorth,-2\nwest,7\n");
+    std::unique_ptr<TableRep> high(filterRows(*table, "amount", FilterOp::GREATER_EQUAL, FilterOperand{"5", true, 5.0}));
+    check(high->rows == 3, "numeric filter skips nulls");
+    std::unique_ptr<TableRep> east(filterRows(*table, "region", FilterOp::EQUAL, FilterOperand{"east", false, 0.0}));
+    check(east->rows == 2, "string filter");
+    AggregateResult sum = aggregateColumn(*table, "amount", AggregateOp::SUM);
+    check(sum.kind == AggregateResult::Kind::NUMBER && sum.number == 20.5, "sum ignores nulls");
+    check(aggregateColumn(*table, "amount", AggregateOp::COUNT).number == 4.0, "count of non-null values");
+    AggregateResult last = aggregateColumn(*table, "region", AggregateOp::MAX);
+    check(last.kind == AggregateResult::Kind::TEXT && last.text == "west", "max of a STRING column");
+    std::unique_ptr<TableRep> groups(groupRows(*table, "region", "amount", AggregateOp::AVG));
+    check(groups->toString() == "region,avg(amount)\neast,10\nwest,6.25\nnorth,-2\n", "group by in first-seen order");
+}
+
+int main() {
+    testCsvPlainFields();
+    testCsvQuotedFields();
+    testCsvEscapedFields();
+    testCsvLongEscapedFields();
+    testCsvMissingTrailingFields();
+    testCsvErrors();
+    testFilterAndAggregate();
+
+    if (failures == 0) {
+        std::cout << "All table tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
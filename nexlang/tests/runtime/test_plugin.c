@@ -0,0 +1,115 @@
+/* Native plugin used by plugin_loader_tests. Built three ways:
+ *   default                    - registers the Test_* builtins
+ *   TEST_PLUGIN_REQUIRED_ABI=N - rejects hosts older than ABI version N
+ *   TEST_PLUGIN_NO_INIT        - does not export nexlang_plugin_init
+ */
+#include "../../builtins/plugin_api.h"
+
+#if defined(_WIN32)
+#define TEST_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define TEST_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef TEST_PLUGIN_NO_INIT
+
+TEST_PLUGIN_EXPORT int nexlang_plugin_version(void) {
+    return 0;
+}
+
+#else
+
+#ifndef TEST_PLUGIN_REQUIRED_ABI
+#define TEST_PLUGIN_REQUIRED_ABI NEXLANG_PLUGIN_ABI_VERSION
+#endif
+
+/* Registrations the host refused during init */
+static double rejected = 0.0;
+
+/* x * x + y * y */
+static void hypot2(const NexValue* args, size_t argc, NexValue* result, const NexHostApi* api) {
+    double x, y;
+    if (argc != 2) {
+        api->raiseError("need 2 arguments");
+        return;
+    }
+    x = api->toFloat(api->arg(args, 0));
+    y = api->toFloat(api->arg(args, 1));
+    api->setFloat(result, x * x + y * y);
+}
+
+/* Element-wise square of a FLOAT array */
+static void square(const NexValue* args, size_t argc, NexValue* result, const NexHostApi* api) {
+    size_t length = 0;
+    size_t i;
+    const double* data = argc == 1 ? api->floatArrayData(api->arg(args, 0), &length) : NULL;
+    double* out;
+    if (!data) {
+        api->raiseError("not a FLOAT array");
+        return;
+    }
+    out = api->newFloatArray(result, length);
+    for (i = 0; i < length; ++i) {
+        out[i] = data[i] * data[i];
+    }
+}
+
+/* Text of a STRING argument with ASCII letters upper-cased */
+static void upper(const NexValue* args, size_t argc, NexValue* result, const NexHostApi* api) {
+    size_t length = 0;
+    size_t i;
+    char buffer[64];
+    const char* text = argc == 1 ? api->stringData(api->arg(args, 0), &length) : NULL;
+    if (!text || length > sizeof(buffer)) {
+        api->raiseError("need a short STRING");
+        return;
+    }
+    for (i = 0; i < length; ++i) {
+        buffer[i] = (text[i] >= 'a' && text[i] <= 'z') ? (char)(text[i] - 'a' + 'A') : text[i];
+    }
+    api->setString(result, buffer, length);
+}
+
+static void isFloat(const NexValue* args, size_t argc, NexValue* result, const NexHostApi* api) {
+    api->setBool(result, argc == 1 && api->typeOf(api->arg(args, 0)) == NEX_VALUE_FLOAT);
+}
+
+static void rejectedCount(const NexValue* args, size_t argc, NexValue* result, const NexHostApi* api) {
+    (void)args;
+    (void)argc;
+    api->setFloat(result, rejected);
+}
+
+TEST_PLUGIN_EXPORT int nexlang_plugin_init(const NexHostApi* api, NexHost* host) {
+    static const NexBuiltinDesc builtins[] = {
+        {"Test_Hypot2", NEX_BUILTIN_MATH_OP, 2, NEX_BUILTIN_PURE, hypot2},
+        {"Test_Square", NEX_BUILTIN_ARRAY_OP, 1, NEX_BUILTIN_PURE, square},
+        {"Test_Upper", NEX_BUILTIN_STRING_OP, 1, NEX_BUILTIN_PURE, upper},
+        {"Test_IsFloat", NEX_BUILTIN_MATH_OP, 1, NEX_BUILTIN_PURE, isFloat},
+        {"Test_Rejected", NEX_BUILTIN_MATH_OP, 0, 0, rejectedCount},
+    };
+    static const NexBuiltinDesc invalid[] = {
+        {"Test_BadKind", 99, 0, 0, rejectedCount},
+        {"Test_BadArgs", NEX_BUILTIN_MATH_OP, -2, 0, rejectedCount},
+        {"Test_NoFn", NEX_BUILTIN_MATH_OP, 0, 0, NULL},
+        {NULL, NEX_BUILTIN_MATH_OP, 0, 0, rejectedCount},
+    };
+    size_t i;
+
+    if (api->abiVersion < TEST_PLUGIN_REQUIRED_ABI) {
+        return 1;
+    }
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        if (api->registerBuiltin(host, &invalid[i]) != 0) {
+            rejected += 1.0;
+        }
+    }
+    for (i = 0; i < sizeof(builtins) / sizeof(builtins[0]); ++i) {
+        if (api->registerBuiltin(host, &builtins[i]) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,135 @@
+// Global symbol table and snapshot publication tests
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../runtime/snapshot_ptr.h"
+#include "../../symbol/global_symbol_table.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+static std::vector<SymbolId> ids(std::vector<const char*> names) {
+    std::vector<SymbolId> result;
+    for (const char* name : names) {
+        result.push_back(internString(name));
+    }
+    return result;
+}
+
+static Symbol operation(const char* name) {
+    Symbol sym;
+    sym.id = internString(name);
+    sym.type = SymbolType::OPERATION;
+    return sym;
+}
+
+// ================= SNAPSHOT POINTER =================
+static void testSnapshotPtr() {
+    SnapshotPtr<std::vector<int>> snapshot;
+    check(snapshot.load() == nullptr, "empty until the first publish");
+    snapshot.publish(std::make_unique<std::vector<int>>(std::vector<int>{1}));
+    const std::vector<int>* first = snapshot.load();
+    snapshot.update([](std::vector<int>& next) { next.push_back(2); });
+    const std::vector<int>* second = snapshot.load();
+    check(second != first && *second == std::vector<int>({1, 2}), "update publishes an edited copy");
+    check(*first == std::vector<int>({1}), "readers of the old version still see it unchanged");
+    snapshot.reclaim();
+    check(snapshot.load() == second && *second == std::vector<int>({1, 2}), "reclaim keeps the current version");
+}
+
+// ================= BASE LAYER =================
+static void testFrozenBase() {
+    SymbolTable table;
+    table.defineOperation("Op_A", ids({"a1", "a2"}));
+    table.defineFunction("Fn_B", ids({"b1"}));
+    table.defineBlock("Block_C", 3);
+    table.defineVariable("var_d", Value(1.0));
+    table.enterScope();
+    table.defineBlock("Op_A", 9);   // shadows the operation while frozen
+    GlobalSymbolTable globals(table);
+    table.exitScope();
+
+    check(globals.lookup("var_d") == nullptr, "variables are not frozen");
+    check(globals.lookup("Block_C") && globals.lookup("Block_C")->block.blockId == 3, "block is frozen");
+    const Symbol* shadowed = globals.lookup("Op_A");
+    check(shadowed && shadowed->type == SymbolType::BLOCK && shadowed->block.blockId == 9,
+          "only the visible definition is frozen");
+    GlobalSymbolTable::Resolved fn = globals.resolve("Fn_B");
+    check(fn && fn.symbol->type == SymbolType::FUNCTION && fn.paramNames() == ids({"b1"}), "function and params");
+    check(globals.lookup("Say") && globals.lookup("Say")->type == SymbolType::BUILTIN, "built-ins are frozen");
+    check(!globals.resolve("Never_Defined_Global"), "unknown name");
+
+    // Later changes to the analyzer's table do not reach the frozen copy
+    table.defineBlock("Block_C", 100);
+    table.defineOperation("Op_Late", ids({"x"}));
+    check(globals.lookup("Block_C")->block.blockId == 3, "base does not follow the source table");
+    check(globals.lookup("Op_Late") == nullptr, "base does not gain symbols");
+}
+
+// ================= RUNTIME OVERLAY =================
+static void testDefineRuntime() {
+    SymbolTable table;
+    table.defineOperation("Op_Base", ids({"p", "q"}));
+    GlobalSymbolTable globals(table);
+    const Symbol* base = globals.lookup("Op_Base");
+
+    Symbol late = operation("Op_Runtime");
+    globals.defineRuntime(late, ids({"r"}));
+    GlobalSymbolTable::Resolved runtime = globals.resolve("Op_Runtime");
+    check(runtime && runtime.paramNames() == ids({"r"}), "runtime definition is visible");
+    check(globals.lookup("Op_Base") == base, "base symbols stay where they were");
+
+    globals.defineRuntime(operation("Op_Base"), ids({"s"}));
+    GlobalSymbolTable::Resolved shadow = globals.resolve("Op_Base");
+    check(shadow.symbol != base && shadow.paramNames() == ids({"s"}), "overlay shadows the base");
+    check(base->type == SymbolType::OPERATION && base->callable.paramCount == 2, "base entry is unchanged");
+
+    // The overlay read before the last publish stays valid until reclaim()
+    check(runtime.symbol->id == internString("Op_Runtime") && runtime.paramNames() == ids({"r"}),
+          "superseded overlay is still readable");
+    globals.reclaim();
+    check(globals.resolve("Op_Runtime").paramNames() == ids({"r"}), "current overlay survives reclaim");
+}
+
+// Regression: params were looked up in whichever layer was current at the
+// time of the call, not the layer the symbol came from
+static void testResolveParamsFromSameLayer() {
+    SymbolTable table;
+    table.defineOperation("Op_First", ids({"f1", "f2", "f3"}));
+    table.defineOperation("Op_Second", ids({"s1", "s2"}));   // firstParam 3 in the base
+    GlobalSymbolTable globals(table);
+
+    GlobalSymbolTable::Resolved before = globals.resolve("Op_Second");
+    check(before.symbol->callable.firstParam == 3, "base symbol indexes past the start");
+
+    // The overlay has one param; the base symbol's firstParam is out of its range
+    globals.defineRuntime(operation("Op_Second"), ids({"o1"}));
+    check(before.paramNames() == ids({"s1", "s2"}), "params read before a publish keep their layer");
+    GlobalSymbolTable::Resolved after = globals.resolve("Op_Second");
+    check(after.paramNames() == ids({"o1"}), "params read after the publish come from the overlay");
+
+    GlobalSymbolTable::Resolved first = globals.resolve("Op_First");
+    globals.defineRuntime(operation("Op_Other"), ids({"x1", "x2", "x3", "x4"}));
+    check(first.paramNames() == ids({"f1", "f2", "f3"}) &&
+              globals.resolve("Op_First").paramNames() == ids({"f1", "f2", "f3"}),
+          "base symbol keeps base params while the overlay grows");
+}
+
+int main() {
+    testSnapshotPtr();
+    testFrozenBase();
+    testDefineRuntime();
+    testResolveParamsFromSameLayer();
+
+    if (failures == 0) {
+        std::cout << "All global symbol table tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// Symbol table tests
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../symbol/symbol_table.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << std::endl;
+        ++failures;
+    }
+}
+
+// ================= SCOPES =================
+static void testShadowing() {
+    SymbolTable table;
+    table.defineVariable("x", Value(1.0));
+    table.enterScope();
+    check(!table.hasLocal("x"), "outer binding is not local to the inner scope");
+    table.defineVariable("x", Value(2.0));
+    check(table.hasLocal("x") && table.lookup("x")->value.getFloat() == 2.0, "inner definition shadows the outer");
+
+    table.enterScope();
+    check(table.lookup("x")->value.getFloat() == 2.0, "nested scope sees the innermost definition");
+    table.exitScope();
+    check(table.scopeDepth() == 1 && table.lookup("x")->value.getFloat() == 2.0, "empty scope leaves no trace");
+}
+
+static void testExitScopeRestores() {
+    SymbolTable table;
+    table.defineVariable("x", Value("outer"));
+    table.enterScope();
+    table.defineVariable("x", Value("inner"));
+    table.defineVariable("y", Value(3.0));
+    table.updateVariable("x", Value("changed"));
+    table.exitScope();
+
+    Symbol* x = table.lookup("x");
+    check(x && x->value.getString() == "outer", "exitScope restores the outer binding");
+    check(table.lookup("y") == nullptr && !table.hasVariable("y"), "inner-only names are gone");
+    check(table.scopeDepth() == 0, "back at the global scope");
+
+    table.exitScope();   // the global scope is never popped
+    check(table.lookup("x") != nullptr && table.lookup("Say") != nullptr, "global scope survives an extra exit");
+}
+
+static void testRedefinitionInSameScope() {
+    SymbolTable table;
+    table.enterScope();
+    table.defineVariable("x", Value(1.0));
+    table.defineVariable("x", Value(2.0), false);
+    Symbol* x = table.lookup("x");
+    check(x && x->value.getFloat() == 2.0 && !x->variable.isMutable, "redefinition replaces the local symbol");
+    check(!table.updateVariable("x", Value(3.0)), "replacement keeps its own mutability");
+
+    size_t visible = 0;
+    table.forEachVisible([&](const Symbol& sym) { visible += sym.name() == "x"; });
+    check(visible == 1, "redefinition does not add a second entry");
+
+    table.exitScope();
+    check(table.lookup("x") == nullptr, "both definitions leave with the scope");
+}
+
+static void testUndefinedLookup() {
+    SymbolTable table;
+    check(table.lookup("never_interned_name_xyz") == nullptr, "name that was never interned");
+    SymbolId unused = internString("interned_but_undefined");
+    check(table.lookup(unused) == nullptr && table.lookupHandle(unused) == kInvalidSymbolHandle,
+          "interned name with no definition");
+    check(!table.hasLocal(unused) && !table.hasVariable(unused), "no local and no variable");
+    check(!table.updateVariable(unused, Value(1.0)), "updating an undefined name fails");
+    check(table.lookup("Say") && table.lookup("Say")->type == SymbolType::BUILTIN, "built-ins are predefined");
+}
+
+// ================= SYMBOL POOL =================
+static void testRedefinitionFreesSlot() {
+    SymbolTable table;
+    table.enterScope();
+    table.defineVariable("x", Value(1.0));
+    SymbolHandle first = table.lookupHandle(internString("x"));
+    table.defineVariable("x", Value(2.0));
+    SymbolHandle second = table.lookupHandle(internString("x"));
+    check(second != first, "redefinition takes a new slot");
+    table.defineVariable("y", Value(3.0));
+    check(table.lookupHandle(internString("y")) == first, "replaced slot is on the free list");
+    check(table.lookup("x")->value.getFloat() == 2.0 && table.lookup("y")->value.getFloat() == 3.0,
+          "reused slot does not disturb the live symbol");
+    table.exitScope();
+
+    SymbolPool pool;
+    SymbolHandle a = pool.allocate(internString("a"), SymbolType::VARIABLE, Value(std::string(40, 'a')));
+    SymbolHandle b = pool.allocate(internString("b"), SymbolType::VARIABLE, Value(1.0));
+    pool.release(a);
+    check(pool[a].value.getType() == ValueType::STRING && pool[a].value.getString().empty(),
+          "released slot drops its value");
+    check(pool.allocate(internString("c"), SymbolType::BLOCK, Value()) == a, "released slot is reused first");
+    check(pool[b].value.getFloat() == 1.0, "other slots are untouched");
+
+    // Symbol* stays valid while the pool grows past a chunk
+    Symbol* stable = &pool[b];
+    for (int i = 0; i < 1000; ++i) {
+        pool.allocate(internString("d"), SymbolType::VARIABLE, Value(static_cast<double>(i)));
+    }
+    check(stable == &pool[b] && stable->value.getFloat() == 1.0, "symbols do not move when the pool grows");
+}
+
+static void testPayloadPerType() {
+    SymbolTable table;
+    SymbolId p1 = internString("p1");
+    SymbolId p2 = internString("p2");
+    table.enterScope();
+    table.defineVariable("constant", Value(1.0), false);
+    table.defineFunction("f", {p1, p2});
+    table.defineOperation("op", {p2});
+    table.defineBlock("blk", 42);
+
+    Symbol* constant = table.lookup("constant");
+    check(constant->type == SymbolType::VARIABLE && !constant->variable.isMutable, "VARIABLE keeps its mutability");
+    Symbol* f = table.lookup("f");
+    check(f->type == SymbolType::FUNCTION && table.paramNames(*f) == std::vector<SymbolId>({p1, p2}),
+          "FUNCTION keeps its parameters");
+    Symbol* op = table.lookup("op");
+    check(op->type == SymbolType::OPERATION && table.paramNames(*op) == std::vector<SymbolId>({p2}),
+          "OPERATION keeps its parameters");
+    Symbol* blk = table.lookup("blk");
+    check(blk->type == SymbolType::BLOCK && blk->block.blockId == 42, "BLOCK keeps its id");
+    Symbol* say = table.lookup("Say");
+    check(say->type == SymbolType::BUILTIN && say->builtin.id == BuiltinsRegistry::getInstance().resolve("Say"),
+          "BUILTIN keeps its registry id");
+    Symbol* statement = table.lookup("DO");
+    check(statement->type == SymbolType::BUILTIN && statement->builtin.id == kInvalidBuiltinId,
+          "BUILTIN without an implementation");
+
+    // Slots freed by the scope come back with a different kind of payload
+    table.exitScope();
+    table.enterScope();
+    table.defineBlock("f", 7);
+    table.defineFunction("blk", {p1});
+    check(table.lookup("f")->type == SymbolType::BLOCK && table.lookup("f")->block.blockId == 7,
+          "reused slot holds the new BLOCK payload");
+    check(table.paramNames(*table.lookup("blk")) == std::vector<SymbolId>({p1}),
+          "reused slot holds the new FUNCTION payload");
+    table.exitScope();
+}
+
+int main() {
+    testShadowing();
+    testExitScopeRestores();
+    testRedefinitionInSameScope();
+    testUndefinedLookup();
+    testRedefinitionFreesSlot();
+    testPayloadPerType();
+
+    if (failures == 0) {
+        std::cout << "All symbol table tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}